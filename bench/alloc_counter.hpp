@@ -0,0 +1,135 @@
+#pragma once
+
+// Global allocation counters for benchmarks and allocation tests.
+// Including this header replaces the global operator new/delete in the
+// program, so it must be included by exactly one translation unit.
+//
+// On glibc it also replaces malloc, calloc, realloc and the aligned
+// allocators, forwarding to glibc's __libc_* entry points, so allocations
+// that bypass operator new are counted too. operator new allocates through
+// malloc there and is counted once, by malloc. On other C libraries only
+// operator new is counted.
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#define ALLOC_COUNTER_MALLOC 1
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t align, size_t size);
+}
+#else
+#define ALLOC_COUNTER_MALLOC 0
+#endif
+
+namespace alloc_counter {
+
+inline std::atomic<size_t> allocations{0};  // Number of allocation calls
+inline std::atomic<size_t> bytes{0};        // Total bytes requested
+
+// operator new calls this thread may still make before they throw
+// std::bad_alloc; tests lower it to inject allocation failures
+inline thread_local size_t allocations_before_failure = SIZE_MAX;
+
+// Snapshot of the counters, used to measure the allocations of a region
+struct Snapshot {
+    size_t allocations;
+    size_t bytes;
+};
+
+inline Snapshot now() {
+    return {allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+}
+
+// Allocations performed since a snapshot was taken
+inline Snapshot since(const Snapshot& start) {
+    Snapshot current = now();
+    return {current.allocations - start.allocations, current.bytes - start.bytes};
+}
+
+inline void count(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+inline void fail_if_due() {
+    if (allocations_before_failure == SIZE_MAX) return;
+    if (allocations_before_failure == 0) throw std::bad_alloc();
+    --allocations_before_failure;
+}
+
+inline void* allocate(size_t size) {
+    fail_if_due();
+    if (!ALLOC_COUNTER_MALLOC) count(size);  // Otherwise malloc counts it
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+inline void* allocate_aligned(size_t size, std::align_val_t align) {
+    fail_if_due();
+    if (!ALLOC_COUNTER_MALLOC) count(size);
+    const size_t a = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace alloc_counter
+
+#if ALLOC_COUNTER_MALLOC
+extern "C" {
+void* malloc(size_t size) {
+    alloc_counter::count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    alloc_counter::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+// Growing or moving a block counts as an allocation of the new size; realloc(p, 0) frees
+void* realloc(void* p, size_t size) {
+    if (size) alloc_counter::count(size);
+    return __libc_realloc(p, size);
+}
+
+void* aligned_alloc(size_t align, size_t size) {
+    alloc_counter::count(size);
+    return __libc_memalign(align, size);
+}
+
+void* memalign(size_t align, size_t size) {
+    alloc_counter::count(size);
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void** out, size_t align, size_t size) {
+    if (align < sizeof(void*) || (align & (align - 1)) != 0) return EINVAL;
+    alloc_counter::count(size);
+    void* p = __libc_memalign(align, size);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+}
+#endif
+
+void* operator new(size_t size) { return alloc_counter::allocate(size); }
+void* operator new[](size_t size) { return alloc_counter::allocate(size); }
+void* operator new(size_t size, std::align_val_t align) { return alloc_counter::allocate_aligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return alloc_counter::allocate_aligned(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
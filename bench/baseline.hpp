@@ -0,0 +1,187 @@
+#pragma once
+
+// JSON results and baseline comparison for the benchmark harness.
+//
+// Results are written one record per line so that the reader below can stay
+// a small line-based parser instead of a general JSON library.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Name of the fixed reference workload used to normalize machine speed
+constexpr const char* calibration_name = "calibration";
+
+// One measured benchmark (all times are ns per element)
+struct Record {
+    std::string name;      // "type/distribution/n/operation"
+    double median_ns = 0;
+    double p95_ns = 0;
+    double stddev_ns = 0;
+    double allocations = 0;  // Per operation
+    double bytes = 0;        // Per operation
+    long peak_rss_kb = 0;    // Process peak RSS after the measurement
+
+    // Hardware counters per element; NAN when unavailable
+    double cycles = NAN;
+    double instructions = NAN;
+    double l1d_misses = NAN;
+    double llc_misses = NAN;
+    double branch_misses = NAN;
+    bool counters_scaled = false;  // Counters were multiplexed and extrapolated
+};
+
+// Formats a counter for JSON, writing null when it is unavailable
+inline std::string json_counter(double value) {
+    if (std::isnan(value)) return "null";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4f", value);
+    return buf;
+}
+
+inline void write_json(const std::string& path, const std::vector<Record>& records) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const Record& r = records[i];
+        char line[1024];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"median_ns\": %.4f, \"p95_ns\": %.4f, \"stddev_ns\": %.4f, "
+                      "\"allocations\": %.2f, \"bytes\": %.2f, \"peak_rss_kb\": %ld, \"cycles\": %s, "
+                      "\"instructions\": %s, \"l1d_misses\": %s, \"llc_misses\": %s, \"branch_misses\": %s, \"counters_scaled\": %s}%s\n",
+                      r.name.c_str(), r.median_ns, r.p95_ns, r.stddev_ns, r.allocations, r.bytes,
+                      r.peak_rss_kb, json_counter(r.cycles).c_str(), json_counter(r.instructions).c_str(),
+                      json_counter(r.l1d_misses).c_str(), json_counter(r.llc_misses).c_str(),
+                      json_counter(r.branch_misses).c_str(), r.counters_scaled ? "true" : "false",
+                      i + 1 < records.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+}
+
+// Extracts the number following "key": on a line, or NAN when absent or null
+inline double json_number(const std::string& line, const std::string& key) {
+    size_t at = line.find("\"" + key + "\":");
+    if (at == std::string::npos) return NAN;
+    const char* value = line.c_str() + at + key.size() + 3;
+    char* end = nullptr;
+    double number = std::strtod(value, &end);
+    return end == value ? NAN : number;
+}
+
+// Reads a file produced by write_json, keyed by record name
+inline std::map<std::string, Record> read_json(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    std::map<std::string, Record> records;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t at = line.find("\"name\": \"");
+        if (at == std::string::npos) continue;
+        size_t start = at + 9;
+        size_t stop = line.find('"', start);
+        Record r;
+        r.name = line.substr(start, stop - start);
+        r.median_ns = json_number(line, "median_ns");
+        r.p95_ns = json_number(line, "p95_ns");
+        r.stddev_ns = json_number(line, "stddev_ns");
+        r.allocations = json_number(line, "allocations");
+        r.bytes = json_number(line, "bytes");
+        r.peak_rss_kb = static_cast<long>(json_number(line, "peak_rss_kb"));
+        r.cycles = json_number(line, "cycles");
+        r.instructions = json_number(line, "instructions");
+        r.l1d_misses = json_number(line, "l1d_misses");
+        r.llc_misses = json_number(line, "llc_misses");
+        r.branch_misses = json_number(line, "branch_misses");
+        r.counters_scaled = line.find("\"counters_scaled\": true") != std::string::npos;
+        records[r.name] = r;
+    }
+    return records;
+}
+
+// Widens a stored baseline with a new run: each record keeps the slower
+// median/p95 and the higher allocation count. Recording a baseline as the
+// envelope of several runs keeps run-to-run noise out of the gate.
+inline std::vector<Record> envelope(const std::vector<Record>& current, const std::map<std::string, Record>& stored) {
+    std::vector<Record> merged = current;
+    for (Record& r : merged) {
+        auto it = stored.find(r.name);
+        if (it == stored.end()) continue;
+        const Record& old = it->second;
+        if (r.name == calibration_name) {
+            r = (old.median_ns < r.median_ns) ? old : r;  // Calibration keeps the fastest run
+            continue;
+        }
+        r.median_ns = std::max(r.median_ns, old.median_ns);
+        r.p95_ns = std::max(r.p95_ns, old.p95_ns);
+        r.stddev_ns = std::max(r.stddev_ns, old.stddev_ns);
+        r.allocations = std::max(r.allocations, old.allocations);
+        r.bytes = std::max(r.bytes, old.bytes);
+        r.peak_rss_kb = std::max(r.peak_rss_kb, old.peak_rss_kb);
+    }
+    return merged;
+}
+
+// Compares results against a baseline and prints every regression.
+// Median or p95 time regresses when it exceeds the baseline's by more than
+// threshold (a fraction, e.g. 0.3 = 30%), after scaling the baseline by the
+// ratio of the two calibration runs so that a uniformly slower machine does
+// not fail the gate. Allocation counts are deterministic, so any increase is a
+// regression. Peak RSS and stddev are reported but not compared.
+// Returns the names of the regressed benchmarks; details are printed when verbose.
+inline std::vector<std::string> compare(const std::vector<Record>& current,
+                                        const std::map<std::string, Record>& baseline,
+                                        double threshold, bool verbose) {
+    double scale = 1.0;
+    auto base_calibration = baseline.find(calibration_name);
+    for (const Record& r : current) {
+        if (r.name == calibration_name && base_calibration != baseline.end() && base_calibration->second.median_ns > 0) {
+            scale = r.median_ns / base_calibration->second.median_ns;
+        }
+    }
+    if (verbose) std::printf("Machine speed relative to baseline: %.2fx\n", scale);
+
+    std::vector<std::string> regressed;
+    size_t compared = 0;
+    for (const Record& r : current) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || r.name == calibration_name) continue;
+        const Record& base = it->second;
+        const double expected = base.median_ns * scale;
+        ++compared;
+
+        const double expected_p95 = base.p95_ns * scale;
+        const bool slower = r.median_ns > expected * (1 + threshold);
+        const bool tail_slower = r.p95_ns > expected_p95 * (1 + threshold);
+        const bool allocates_more = r.allocations > base.allocations + 0.5;
+        if (slower && verbose) {
+            std::printf("REGRESSION %-45s median %10.2f ns/elem vs baseline %10.2f (+%.0f%%)\n",
+                        r.name.c_str(), r.median_ns, expected, (r.median_ns / expected - 1) * 100);
+        }
+        if (tail_slower && verbose) {
+            std::printf("REGRESSION %-45s p95 %10.2f ns/elem vs baseline %10.2f (+%.0f%%)\n",
+                        r.name.c_str(), r.p95_ns, expected_p95, (r.p95_ns / expected_p95 - 1) * 100);
+        }
+        if (allocates_more && verbose) {
+            std::printf("REGRESSION %-45s allocations %.1f/op vs baseline %.1f/op\n",
+                        r.name.c_str(), r.allocations, base.allocations);
+        }
+        if (slower || tail_slower || allocates_more) regressed.push_back(r.name);
+    }
+    if (verbose) {
+        std::printf("Compared %zu benchmarks against baseline: %zu regression(s) (threshold %.0f%%)\n",
+                    compared, regressed.size(), threshold * 100);
+    }
+    return regressed;
+}
+
+} // namespace bench
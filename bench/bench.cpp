@@ -0,0 +1,434 @@
+// Benchmark harness for MyContainer hot paths.
+//
+// Measures add, remove, every order iterator and operator<< for several
+// element types, sizes and input distributions, and reports ns/element
+// together with the allocations performed by each operation.
+//
+// Each benchmark runs warm-up repetitions first, then at least --reps timed
+// repetitions (more until --min-time-ms is reached), and reports the median,
+// p95 and standard deviation. Hardware counters (cycles, instructions, L1D
+// and LLC misses, branch misses) are read around every timed region when the
+// kernel allows it (--no-counters turns them off). With --json the results are saved, and with
+// --baseline they are compared against a stored run; the process exits with
+// status 1 when a tracked metric regresses past --threshold.
+//
+// Usage: bench_bin [--max-n N] [--min-time-ms MS] [--warmup N] [--reps N] [--filter TEXT]
+//                  [--json FILE] [--baseline FILE] [--threshold FRACTION] [--retries N]
+//                  [--envelope FILE] [--no-counters]
+//
+// --envelope merges this run into an existing baseline file, keeping the
+// slower of the two measurements for every benchmark.
+
+#include "alloc_counter.hpp"
+#include "baseline.hpp"
+#include "perf_counters.hpp"
+#include "../include/MyContainer.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace myns;
+
+// ========================= CUSTOM TYPE =========================
+
+struct Point {
+    int x, y;
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+    bool operator<(const Point& other) const { return (x < other.x) || (x == other.x && y < other.y); }
+    friend std::ostream& operator<<(std::ostream& os, const Point& p) {
+        return os << "(" << p.x << "," << p.y << ")";
+    }
+};
+
+// ========================= INPUT GENERATION =========================
+
+enum class Distribution { Random, Sorted, Reverse, Duplicates };
+
+const char* distribution_name(Distribution d) {
+    switch (d) {
+        case Distribution::Random: return "random";
+        case Distribution::Sorted: return "sorted";
+        case Distribution::Reverse: return "reverse";
+        case Distribution::Duplicates: return "dups";
+    }
+    return "?";
+}
+
+// Number of distinct values in the duplicate-heavy distribution
+constexpr uint64_t duplicate_range = 16;
+
+// Produces n integer keys in [0, range) following the distribution
+std::vector<uint64_t> make_keys(size_t n, Distribution d, uint64_t& range) {
+    std::mt19937_64 rng(12345);
+    std::vector<uint64_t> keys(n);
+    range = (d == Distribution::Duplicates) ? duplicate_range : std::max<uint64_t>(n, 1);
+    for (size_t i = 0; i < n; ++i) {
+        switch (d) {
+            case Distribution::Random: keys[i] = rng() % range; break;
+            case Distribution::Sorted: keys[i] = i; break;
+            case Distribution::Reverse: keys[i] = n - 1 - i; break;
+            case Distribution::Duplicates: keys[i] = rng() % range; break;
+        }
+    }
+    return keys;
+}
+
+// Maps a key to a value of T, preserving key order
+template<typename T> T make_value(uint64_t key, uint64_t range);
+
+template<> int make_value<int>(uint64_t key, uint64_t) { return static_cast<int>(key); }
+template<> double make_value<double>(uint64_t key, uint64_t) { return static_cast<double>(key) + 0.5; }
+template<> char make_value<char>(uint64_t key, uint64_t range) {
+    return static_cast<char>(32 + key * 95 / range);
+}
+template<> std::string make_value<std::string>(uint64_t key, uint64_t) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%012llu", static_cast<unsigned long long>(key));
+    return buf;
+}
+template<> Point make_value<Point>(uint64_t key, uint64_t) {
+    return {static_cast<int>(key / 1000), static_cast<int>(key % 1000)};
+}
+
+template<typename T>
+std::vector<T> make_values(size_t n, Distribution d) {
+    uint64_t range = 0;
+    std::vector<uint64_t> keys = make_keys(n, d, range);
+    std::vector<T> values;
+    values.reserve(n);
+    for (uint64_t k : keys) values.push_back(make_value<T>(k, range));
+    return values;
+}
+
+// ========================= MEASUREMENT =========================
+
+struct Options {
+    size_t max_n = 1000000;
+    double min_time_ms = 50;
+    size_t warmup = 1;
+    size_t reps = 5;
+    std::string filter;
+    std::string exact_op;       // When set, only this operation runs (used for re-measuring)
+    std::string json_path;
+    std::string baseline_path;
+    std::string envelope_path;  // Baseline file to widen with this run
+    double threshold = 0.3;
+    size_t retries = 3;
+    bool counters = true;
+};
+
+// True when the operation passes the --filter and exact_op selection
+bool wanted(const Options& opt, const std::string& name) {
+    if (!opt.exact_op.empty()) return name == opt.exact_op;
+    return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+}
+
+// Every measured benchmark, in run order
+std::vector<bench::Record> records;
+
+// Hardware counters, or nullptr when disabled or unavailable
+bench::PerfCounters* counters = nullptr;
+
+// Minimum number of elements processed per timed sample (see measure)
+constexpr size_t batch_elements = 10000;
+
+// Keeps the optimizer from discarding benchmarked work
+volatile size_t sink = 0;
+
+// Peak resident set size of the process so far
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Value at fraction q of sorted samples (nearest rank)
+double percentile(const std::vector<double>& sorted, double q) {
+    size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+// Times op(state) after opt.warmup untimed runs, for at least opt.reps repetitions
+// and until min_time_ms has elapsed; setup() runs untimed before each call.
+// Small inputs are batched so that every timed sample covers enough elements
+// to rise above clock resolution.
+template<typename Setup, typename Op>
+bench::Record measure(size_t n, const Options& opt, Setup setup, Op op) {
+    using clock = std::chrono::steady_clock;
+    for (size_t i = 0; i < opt.warmup; ++i) {
+        auto state = setup();
+        op(state);
+    }
+
+    const size_t batch = std::max<size_t>(1, batch_elements / std::max<size_t>(n, 1));
+    std::vector<double> samples;  // ns per element, one per repetition
+    double total_ns = 0;
+    size_t allocs = 0, bytes = 0;
+    bench::CounterValues counted;
+
+    while (samples.size() < std::max<size_t>(opt.reps, 1) || total_ns < opt.min_time_ms * 1e6) {
+        std::vector<decltype(setup())> states;
+        states.reserve(batch);
+        for (size_t i = 0; i < batch; ++i) states.push_back(setup());
+
+        alloc_counter::Snapshot before = alloc_counter::now();
+        if (counters) counters->start();
+        auto start = clock::now();
+        for (auto& state : states) op(state);
+        auto stop = clock::now();
+        if (counters) counters->stop(counted);
+        alloc_counter::Snapshot used = alloc_counter::since(before);
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        total_ns += ns;
+        samples.push_back(ns / batch / std::max<size_t>(n, 1));
+        allocs += used.allocations;
+        bytes += used.bytes;
+    }
+    const size_t ops = samples.size() * batch;
+
+    std::sort(samples.begin(), samples.end());
+    double mean = 0;
+    for (double s : samples) mean += s;
+    mean /= samples.size();
+    double variance = 0;
+    for (double s : samples) variance += (s - mean) * (s - mean);
+
+    bench::Record r;
+    r.median_ns = percentile(samples, 0.5);
+    r.p95_ns = percentile(samples, 0.95);
+    r.stddev_ns = std::sqrt(variance / samples.size());
+    r.allocations = static_cast<double>(allocs) / ops;
+    r.bytes = static_cast<double>(bytes) / ops;
+    r.peak_rss_kb = peak_rss_kb();
+
+    const double elements = static_cast<double>(ops) * std::max<size_t>(n, 1);
+    r.cycles = counted.cycles() / elements;
+    r.instructions = counted.instructions() / elements;
+    r.l1d_misses = counted.l1d_misses() / elements;
+    r.llc_misses = counted.llc_misses() / elements;
+    r.branch_misses = counted.branch_misses() / elements;
+    r.counters_scaled = counted.scaled;
+    return r;
+}
+
+// Prints a per-element counter, or "-" when it is unavailable
+void print_counter(double value) {
+    if (std::isnan(value)) std::printf(" %8s", "-");
+    else std::printf(" %8.2f", value);
+}
+
+void report(const char* type, Distribution d, size_t n, const char* op, bench::Record r) {
+    std::printf("%-8s %-8s %10zu  %-24s %10.2f %10.2f %9.2f %10.1f %12.1f %10ld",
+                type, distribution_name(d), n, op, r.median_ns, r.p95_ns, r.stddev_ns,
+                r.allocations, r.bytes, r.peak_rss_kb);
+    if (counters) {
+        print_counter(r.cycles);
+        print_counter(r.instructions);
+        print_counter(r.l1d_misses);
+        print_counter(r.llc_misses);
+        print_counter(r.branch_misses);
+        if (r.counters_scaled) std::printf(" scaled");
+    }
+    std::printf("\n");
+    r.name = std::string(type) + "/" + distribution_name(d) + "/" + std::to_string(n) + "/" + op;
+    records.push_back(std::move(r));
+}
+
+// Times a fixed workload (sorting 10^5 random ints) whose result is used to
+// normalize comparisons against a baseline recorded on a faster or slower box
+void calibrate(const Options& opt) {
+    std::vector<int> input(100000);
+    std::mt19937 rng(42);
+    for (int& x : input) x = static_cast<int>(rng());
+    bench::Record r = measure(input.size(), opt, [&] { return input; }, [](std::vector<int>& v) {
+        std::sort(v.begin(), v.end());
+        sink = sink + v[0];
+    });
+    r.name = bench::calibration_name;
+    std::printf("calibration: %.2f ns/elem\n", r.median_ns);
+    records.push_back(r);
+}
+
+// Runs one order benchmark: construct the order and traverse it fully
+template<typename T, typename MakeOrder>
+void bench_order(const char* type, Distribution d, const MyContainer<T>& c, const Options& opt,
+                 const char* name, MakeOrder make_order) {
+    if (!wanted(opt, name)) return;
+    bench::Record r = measure(c.size(), opt, [] { return 0; }, [&](int) {
+        size_t count = 0;
+        for (const auto& x : make_order()) { (void)x; ++count; }
+        sink = sink + count;
+    });
+    report(type, d, c.size(), name, r);
+}
+
+template<typename T>
+void bench_type(const char* type, size_t n, Distribution d, const Options& opt) {
+    const std::vector<T> values = make_values<T>(n, d);
+
+    if (wanted(opt, "add")) {
+        bench::Record r = measure(n, opt, [] { return MyContainer<T>(); }, [&](MyContainer<T>& c) {
+            for (const T& v : values) c.add(v);
+            sink = sink + c.size();
+        });
+        report(type, d, n, "add", r);
+    }
+
+    // The sort backend chosen for T, on its own (copy excluded)
+    if (wanted(opt, "sort_backend")) {
+        bench::Record r = measure(n, opt, [&] { return values; }, [](std::vector<T>& v) {
+            detail::sort_ascending(v);
+            sink = sink + v.size();
+        });
+        report(type, d, n, "sort_backend", r);
+    }
+
+    MyContainer<T> c;
+    for (const T& v : values) c.add(v);
+
+    if (wanted(opt, "remove") && n > 0) {
+        bench::Record r = measure(n, opt, [&] { return MyContainer<T>(c.get_data()); }, [&](MyContainer<T>& copy) {
+            copy.remove(values[n / 2]);
+            sink = sink + copy.size();
+        });
+        report(type, d, n, "remove", r);
+    }
+
+    bench_order(type, d, c, opt, "ascending_order", [&] { return c.ascending_order(); });
+    bench_order(type, d, c, opt, "descending_order", [&] { return c.descending_order(); });
+    bench_order(type, d, c, opt, "sidecross_order", [&] { return c.sidecross_order(); });
+    bench_order(type, d, c, opt, "reverse_order", [&] { return c.reverse_order(); });
+    bench_order(type, d, c, opt, "order", [&] { return c.order(); });
+    bench_order(type, d, c, opt, "middle_out_order", [&] { return c.middle_out_order(); });
+    bench_order(type, d, c, opt, "grouped_ascending_order", [&] { return c.grouped_ascending_order(); });
+    bench_order(type, d, c, opt, "distinct_order", [&] { return c.distinct_order(); });
+    bench_order(type, d, c, opt, "frequency_order", [&] { return c.frequency_order(); });
+
+    if (wanted(opt, "operator<<")) {
+        bench::Record r = measure(n, opt, [] { return 0; }, [&](int) {
+            std::ostringstream os;
+            os << c;
+            sink = sink + os.tellp();
+        });
+        report(type, d, n, "operator<<", r);
+    }
+}
+
+// Runs every operation for each element type at one size and distribution
+void bench_all_types(size_t n, Distribution d, const Options& opt) {
+    bench_type<int>("int", n, d, opt);
+    bench_type<double>("double", n, d, opt);
+    bench_type<char>("char", n, d, opt);
+    bench_type<std::string>("string", n, d, opt);
+    bench_type<Point>("Point", n, d, opt);
+}
+
+// Re-measures one benchmark by its record name ("type/dist/n/op") and keeps
+// the faster of the old and new measurements
+void rerun(const std::string& name, Options opt) {
+    size_t a = name.find('/'), b = name.find('/', a + 1), c = name.find('/', b + 1);
+    const std::string type = name.substr(0, a), dist = name.substr(a + 1, b - a - 1);
+    const size_t n = std::stoull(name.substr(b + 1, c - b - 1));
+    opt.exact_op = name.substr(c + 1);
+
+    const Distribution dists[] = {Distribution::Random, Distribution::Sorted,
+                                  Distribution::Reverse, Distribution::Duplicates};
+    for (Distribution d : dists) {
+        if (dist != distribution_name(d)) continue;
+        if (type == "int") bench_type<int>("int", n, d, opt);
+        else if (type == "double") bench_type<double>("double", n, d, opt);
+        else if (type == "char") bench_type<char>("char", n, d, opt);
+        else if (type == "string") bench_type<std::string>("string", n, d, opt);
+        else if (type == "Point") bench_type<Point>("Point", n, d, opt);
+    }
+
+    // report() appended the new measurement; fold it into the original record
+    if (records.empty() || records.back().name != name) return;
+    bench::Record fresh = records.back();
+    records.pop_back();
+    for (bench::Record& r : records) {
+        if (r.name != name) continue;
+        const double best_p95 = std::min(r.p95_ns, fresh.p95_ns);
+        if (fresh.median_ns < r.median_ns) r = fresh;
+        r.p95_ns = best_p95;  // Median and p95 each keep their best measurement
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--max-n" && has_value) opt.max_n = std::stoull(argv[++i]);
+        else if (arg == "--min-time-ms" && has_value) opt.min_time_ms = std::stod(argv[++i]);
+        else if (arg == "--warmup" && has_value) opt.warmup = std::stoull(argv[++i]);
+        else if (arg == "--reps" && has_value) opt.reps = std::stoull(argv[++i]);
+        else if (arg == "--filter" && has_value) opt.filter = argv[++i];
+        else if (arg == "--json" && has_value) opt.json_path = argv[++i];
+        else if (arg == "--baseline" && has_value) opt.baseline_path = argv[++i];
+        else if (arg == "--threshold" && has_value) opt.threshold = std::stod(argv[++i]);
+        else if (arg == "--retries" && has_value) opt.retries = std::stoull(argv[++i]);
+        else if (arg == "--envelope" && has_value) opt.envelope_path = argv[++i];
+        else if (arg == "--no-counters") opt.counters = false;
+        else {
+            std::fprintf(stderr, "Usage: %s [--max-n N] [--min-time-ms MS] [--warmup N] [--reps N] "
+                                 "[--filter TEXT] [--json FILE] [--baseline FILE] [--threshold FRACTION] "
+                                 "[--retries N] [--envelope FILE] [--no-counters]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    bench::PerfCounters perf;  // Before the first parallel sort, so the pool workers inherit the counters
+    if (opt.counters && perf.available()) counters = &perf;
+    else if (opt.counters) std::printf("Hardware counters unavailable (perf_event_open failed); reporting time only\n");
+
+    std::printf("%-8s %-8s %10s  %-24s %10s %10s %9s %10s %12s %10s", "type", "dist", "n", "operation",
+                "median", "p95", "stddev", "allocs/op", "bytes/op", "rss_kb");
+    if (counters) std::printf(" %8s %8s %8s %8s %8s", "cyc/el", "ins/el", "L1Dm/el", "LLCm/el", "brm/el");
+    std::printf("\n");
+
+    calibrate(opt);
+
+    const Distribution dists[] = {Distribution::Random, Distribution::Sorted,
+                                  Distribution::Reverse, Distribution::Duplicates};
+    for (size_t n = 10; n <= opt.max_n; n *= 10) {
+        for (Distribution d : dists) bench_all_types(n, d, opt);
+    }
+
+    int status = 0;
+    if (!opt.baseline_path.empty()) {
+        const auto baseline = bench::read_json(opt.baseline_path);
+        std::vector<std::string> regressed = bench::compare(records, baseline, opt.threshold, false);
+
+        // A shared box produces one-off slow samples; only regressions that
+        // reproduce on every re-measurement fail the run
+        for (size_t attempt = 1; attempt <= opt.retries && !regressed.empty(); ++attempt) {
+            std::printf("Re-measuring %zu suspected regression(s), attempt %zu/%zu\n",
+                        regressed.size(), attempt, opt.retries);
+            calibrate(opt);
+            bench::Record fresh = records.back();  // Keep the faster calibration at the front
+            records.pop_back();
+            if (fresh.median_ns < records.front().median_ns) records.front() = fresh;
+            for (const std::string& name : regressed) rerun(name, opt);
+            regressed = bench::compare(records, baseline, opt.threshold, false);
+        }
+        status = bench::compare(records, baseline, opt.threshold, true).empty() ? 0 : 1;
+    }
+    if (!opt.json_path.empty()) bench::write_json(opt.json_path, records);
+    if (!opt.envelope_path.empty()) {
+        bench::write_json(opt.envelope_path, bench::envelope(records, bench::read_json(opt.envelope_path)));
+    }
+    return status;
+}
@@ -0,0 +1,161 @@
+// Reader contention benchmark: ReadMostlyContainer against a MyContainer
+// guarded by std::shared_mutex.
+//
+// For each thread count (1, 2, 4, ... up to --max-threads) the reader threads
+// look up random indices for --ms milliseconds while one writer adds and
+// removes an element every --write-every-us microseconds. It reports total
+// reads per second for both containers, and the writes that got through.
+// ReadMostlyContainer readers go through read(), the guarded in-place path;
+// snapshot() writes a shared reference count and is not what this measures.
+//
+// Usage: contention_bin [--max-threads N] [--n N] [--ms MS] [--write-every-us US]
+
+#include "../include/ReadMostlyContainer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace myns;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    size_t max_threads = 64;
+    size_t n = 1024;             // Elements in the container
+    double ms = 200;             // Measured time per thread count
+    double write_every_us = 1000;
+};
+
+struct Result {
+    double reads_per_sec;
+    uint64_t writes;
+};
+
+// Cheap per-thread index generator (xorshift64)
+struct Rng {
+    uint64_t state;
+    explicit Rng(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// Runs `threads` readers and one writer for opt.ms; read(rng) does one lookup,
+// write(k) does one change
+template<typename Read, typename Write>
+Result run(const Options& opt, size_t threads, Read read, Write write) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::vector<uint64_t> reads(threads * 8, 0);  // One cache line per reader
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < threads; ++t) {
+        readers.emplace_back([&, t] {
+            Rng rng(t + 1);
+            uint64_t count = 0, sink = 0;
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+            while (!stop.load(std::memory_order_relaxed)) {
+                sink += read(rng);
+                ++count;
+            }
+            reads[t * 8] = count + (sink == 1 ? 1 : 0);  // Keeps the lookups alive
+        });
+    }
+
+    uint64_t writes = 0;
+    std::thread writer([&] {
+        while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        auto next = Clock::now();
+        while (!stop.load(std::memory_order_relaxed)) {
+            write(writes++);
+            next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(opt.write_every_us));
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    const auto begin = Clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(opt.ms));
+    stop.store(true);
+    for (auto& r : readers) r.join();
+    writer.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    uint64_t total = 0;
+    for (size_t t = 0; t < threads; ++t) total += reads[t * 8];
+    return {total / seconds, writes};
+}
+
+// Readers take a shared lock around every lookup
+Result run_shared_mutex(const Options& opt, size_t threads) {
+    MyContainer<int> c;
+    for (size_t i = 0; i < opt.n; ++i) c.add(static_cast<int>(i));
+    const MyContainer<int>& cc = c;
+    std::shared_mutex mutex;
+
+    return run(opt, threads,
+        [&](Rng& rng) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return cc[rng.next() % opt.n];
+        },
+        [&](uint64_t k) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            if (k % 2 == 0) c.add(-1);
+            else c.remove(-1);
+        });
+}
+
+// Readers enter an epoch guard around every lookup
+Result run_read_mostly(const Options& opt, size_t threads) {
+    ReadMostlyContainer<int> c;
+    c.update([&opt](MyContainer<int>& m) {
+        for (size_t i = 0; i < opt.n; ++i) m.add(static_cast<int>(i));
+    });
+
+    return run(opt, threads,
+        [&](Rng& rng) {
+            return c.read([&rng, &opt](const std::vector<int>& v) { return v[rng.next() % opt.n]; });
+        },
+        [&](uint64_t k) {
+            if (k % 2 == 0) c.add(-1);
+            else c.remove(-1);
+        });
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--max-threads" && has_value) opt.max_threads = std::stoull(argv[++i]);
+        else if (arg == "--n" && has_value) opt.n = std::stoull(argv[++i]);
+        else if (arg == "--ms" && has_value) opt.ms = std::stod(argv[++i]);
+        else if (arg == "--write-every-us" && has_value) opt.write_every_us = std::stod(argv[++i]);
+        else {
+            std::fprintf(stderr, "Usage: %s [--max-threads N] [--n N] [--ms MS] [--write-every-us US]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (opt.n == 0) opt.n = 1;
+
+    std::printf("%zu elements, one writer every %.0f us, %u hardware threads\n", opt.n, opt.write_every_us,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %18s %8s %18s %8s %8s\n", "readers", "shared_mutex r/s", "writes", "read_mostly r/s",
+                "writes", "speedup");
+    for (size_t threads = 1; threads <= opt.max_threads; threads *= 2) {
+        Result locked = run_shared_mutex(opt, threads);
+        Result rcu = run_read_mostly(opt, threads);
+        std::printf("%8zu %18.3e %8llu %18.3e %8llu %7.2fx\n", threads, locked.reads_per_sec,
+                    static_cast<unsigned long long>(locked.writes), rcu.reads_per_sec,
+                    static_cast<unsigned long long>(rcu.writes), rcu.reads_per_sec / locked.reads_per_sec);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+// Hardware performance counters for the benchmark harness.
+//
+// On Linux the counters are read through perf_event_open(2), counting user
+// space only. They form one group, so the PMU schedules them together and the
+// ratios between them come from the same intervals. An event the PMU lacks
+// (or a container/VM without PMU access at all) is left out of the group and
+// reported as unavailable instead of failing the run.
+//
+// The counters are inherited by threads the calling thread creates after they
+// are opened, so construct PerfCounters before the first parallel sort starts
+// ThreadPool::shared(). When the kernel multiplexes the group with other
+// events, the counts are scaled by time enabled / time running and marked as
+// scaled.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// Counter totals for one measured region; NAN marks an unavailable counter
+struct CounterValues {
+    static constexpr int count = 5;
+    double values[count] = {NAN, NAN, NAN, NAN, NAN};
+    bool scaled = false;  // Extrapolated from a multiplexed share of the time
+
+    double& cycles() { return values[0]; }
+    double& instructions() { return values[1]; }
+    double& l1d_misses() { return values[2]; }
+    double& llc_misses() { return values[3]; }
+    double& branch_misses() { return values[4]; }
+};
+
+class PerfCounters {
+    int fds[CounterValues::count] = {-1, -1, -1, -1, -1};
+    int leader = -1;                        // First counter opened; the others join its group
+    int slots[CounterValues::count] = {};   // Counter index of each value in a group read
+    int members = 0;
+
+#if defined(__linux__)
+    int open_counter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = leader < 0 ? 1 : 0;  // Siblings follow the leader
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+        if (fd >= 0 && leader < 0) leader = fd;
+        return fd;
+    }
+
+    void add(int index, uint32_t type, uint64_t config) {
+        fds[index] = open_counter(type, config);
+        if (fds[index] >= 0) slots[members++] = index;
+    }
+#endif
+
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        add(0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        add(1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        add(2, PERF_TYPE_HW_CACHE, l1d_read_miss);
+        add(3, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        add(4, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True when at least one counter could be opened
+    bool available() const { return leader >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stops counting and adds the counts since start() to totals, scaled up
+    // when the group only ran for part of the time
+    void stop(CounterValues& totals) {
+#if defined(__linux__)
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // Layout for PERF_FORMAT_GROUP: nr, time enabled, time running, then one value per member
+        uint64_t data[3 + CounterValues::count] = {};
+        const ssize_t expected = static_cast<ssize_t>((3 + members) * sizeof(uint64_t));
+        if (read(leader, data, sizeof(data)) < expected || data[0] != static_cast<uint64_t>(members)) return;
+        const uint64_t enabled = data[1], running = data[2];
+        if (running == 0) return;  // Never scheduled: nothing to extrapolate from
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        if (running < enabled) totals.scaled = true;
+        for (int m = 0; m < members; ++m) {
+            double& total = totals.values[slots[m]];
+            if (std::isnan(total)) total = 0;
+            total += static_cast<double>(data[3 + m]) * scale;
+        }
+#else
+        (void)totals;
+#endif
+    }
+};
+
+} // namespace bench
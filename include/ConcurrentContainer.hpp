@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MyContainer.hpp"
+
+// ConcurrentContainer<T> - a MyContainer that many threads can add() to at once.
+//
+// Elements live in segmented storage: segment k holds first_segment << k
+// elements, so storage doubles without ever moving an element, and a
+// reference to an element stays valid for the container's lifetime.
+//
+// add() reserves a slot with one atomic increment, constructs the element in
+// place and marks the slot ready; it never waits for another thread. The
+// published size is then advanced over the prefix of ready slots, by add() and
+// by size(), so a producer stalled before marking its slot delays when later
+// elements become visible but never blocks their producers. Readers only look
+// at the published prefix, so they never take a lock and never see a half-built
+// element. Elements cannot be removed.
+//
+// If T's copy constructor throws, add() marks its slot lost and rethrows. A
+// lost slot still counts in size(), at() throws for it and snapshot() skips it.
+//
+// The orders run over snapshot(), a MyContainer<T> holding a copy of the
+// published prefix.
+
+namespace myns {
+
+template<typename T = int>
+class ConcurrentContainer {
+public:
+    static constexpr unsigned first_segment_bits = 5;  // The first segment holds 32 elements
+    static constexpr size_t first_segment = size_t(1) << first_segment_bits;
+    static constexpr size_t max_segments = 64 - first_segment_bits;
+
+    ConcurrentContainer() = default;
+    ~ConcurrentContainer();
+
+    // Shares raw segments between threads, so it is neither copyable nor movable
+    ConcurrentContainer(const ConcurrentContainer&) = delete;
+    ConcurrentContainer& operator=(const ConcurrentContainer&) = delete;
+
+    void add(const T& value);                  // Append from any thread
+    size_t size() const;                       // Number of published elements
+
+    // Access published elements; index must be below a size() already observed
+    const T& at(size_t index) const;           // Throws std::out_of_range past the published size,
+                                               // std::runtime_error for a lost slot
+    const T& operator[](size_t index) const;   // No bounds check; index must not be a lost slot
+
+    MyContainer<T> snapshot() const;           // Copy of the published prefix, for running orders
+
+private:
+    enum SlotState : unsigned char { Empty, Ready, Lost };
+    using Flag = std::atomic<unsigned char>;
+
+    // A segment is one block: its elements, then one state flag per element
+    std::atomic<T*> segments[max_segments] = {};
+    std::atomic<size_t> reserved{0};           // Slots handed out to add()
+    mutable std::atomic<size_t> published{0};  // Slots [0, published) are ready or lost, and visible
+
+    // Segment number and offset within it for an element index
+    static std::pair<size_t, size_t> locate(size_t index) {
+        const size_t p = index + first_segment;
+        const size_t segment = 63 - static_cast<size_t>(__builtin_clzll(p)) - first_segment_bits;
+        return {segment, p - (first_segment << segment)};
+    }
+
+    static size_t segment_size(size_t segment) { return first_segment << segment; }
+
+    // Block length in T units: the elements plus room for their flags
+    static size_t segment_block(size_t segment) {
+        return segment_size(segment) + (segment_size(segment) * sizeof(Flag) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    static Flag* flags_of(T* seg, size_t segment) {
+        return reinterpret_cast<Flag*>(seg + segment_size(segment));
+    }
+
+    T* segment_for_write(size_t segment) noexcept;
+    SlotState state(size_t index) const;       // Empty while the slot's segment is missing
+    void advance() const;                      // Moves published over the ready or lost prefix
+};
+
+
+// Implementation
+
+// Destroys every constructed element and releases the segments; no add() may be running
+template<typename T>
+ConcurrentContainer<T>::~ConcurrentContainer() {
+    const size_t n = reserved.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+        if (state(i) == Ready) (*this)[i].~T();
+    }
+
+    std::allocator<T> alloc;
+    for (size_t s = 0; s < max_segments; ++s) {
+        if (T* seg = segments[s].load(std::memory_order_relaxed)) alloc.deallocate(seg, segment_block(s));
+    }
+}
+
+// Returns the storage of a segment, allocating it if this thread is first to need it.
+// Threads racing on the same segment agree on one allocation through a CAS. A
+// slot whose segment cannot be allocated could never be marked, and would hold
+// back every later element, so running out of memory here terminates.
+template<typename T>
+T* ConcurrentContainer<T>::segment_for_write(size_t segment) noexcept {
+    T* seg = segments[segment].load(std::memory_order_acquire);
+    if (seg) return seg;
+
+    std::allocator<T> alloc;
+    T* fresh = alloc.allocate(segment_block(segment));
+    Flag* flags = flags_of(fresh, segment);
+    for (size_t i = 0; i < segment_size(segment); ++i) ::new (static_cast<void*>(flags + i)) Flag(Empty);
+    if (segments[segment].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel)) return fresh;
+    alloc.deallocate(fresh, segment_block(segment));  // Another thread won; seg now holds its segment
+    return seg;
+}
+
+template<typename T>
+typename ConcurrentContainer<T>::SlotState ConcurrentContainer<T>::state(size_t index) const {
+    const auto [segment, offset] = locate(index);
+    T* seg = segments[segment].load(std::memory_order_acquire);
+    if (!seg) return Empty;
+    return static_cast<SlotState>(flags_of(seg, segment)[offset].load(std::memory_order_acquire));
+}
+
+// Any thread may move published forward; a CAS that loses to another thread
+// just continues from the value that thread stored
+template<typename T>
+void ConcurrentContainer<T>::advance() const {
+    size_t p = published.load(std::memory_order_acquire);
+    while (p < reserved.load(std::memory_order_acquire) && state(p) != Empty) {
+        if (published.compare_exchange_weak(p, p + 1, std::memory_order_acq_rel, std::memory_order_acquire)) ++p;
+    }
+}
+
+// Appends an element: reserve a slot, construct it, mark it, then publish what is ready
+template<typename T>
+void ConcurrentContainer<T>::add(const T& value) {
+    const size_t index = reserved.fetch_add(1, std::memory_order_relaxed);
+    const auto [segment, offset] = locate(index);
+    T* seg = segment_for_write(segment);
+    Flag& flag = flags_of(seg, segment)[offset];
+    try {
+        ::new (static_cast<void*>(seg + offset)) T(value);
+    } catch (...) {
+        flag.store(Lost, std::memory_order_release);  // Later slots must not wait on this one
+        advance();
+        throw;
+    }
+    flag.store(Ready, std::memory_order_release);
+    advance();
+}
+
+// Returns the number of published elements, publishing any that became ready
+template<typename T>
+size_t ConcurrentContainer<T>::size() const {
+    advance();
+    return published.load(std::memory_order_acquire);
+}
+
+// Access a published element with bounds checking
+template<typename T>
+const T& ConcurrentContainer<T>::at(size_t index) const {
+    if (index >= size()) throw std::out_of_range("ConcurrentContainer index out of range");
+    if (state(index) == Lost) throw std::runtime_error("ConcurrentContainer slot lost to a throwing copy");
+    return (*this)[index];
+}
+
+// Access a published element without bounds checking
+template<typename T>
+const T& ConcurrentContainer<T>::operator[](size_t index) const {
+    const auto [segment, offset] = locate(index);
+    return segments[segment].load(std::memory_order_acquire)[offset];
+}
+
+// Copies the published prefix into a MyContainer, one segment at a time,
+// leaving out lost slots
+template<typename T>
+MyContainer<T> ConcurrentContainer<T>::snapshot() const {
+    const size_t n = size();
+    std::vector<T> values;
+    values.reserve(n);
+    for (size_t s = 0, start = 0; start < n; start += segment_size(s), ++s) {
+        T* seg = segments[s].load(std::memory_order_acquire);
+        const Flag* flags = flags_of(seg, s);
+        const size_t count = std::min(segment_size(s), n - start);
+        for (size_t i = 0; i < count;) {
+            size_t end = i;  // Copy each run of ready slots in one insert
+            while (end < count && flags[end].load(std::memory_order_relaxed) == Ready) ++end;
+            values.insert(values.end(), seg + i, seg + end);
+            i = end == i ? end + 1 : end;
+        }
+    }
+    return MyContainer<T>(std::move(values));
+}
+
+} // namespace myns
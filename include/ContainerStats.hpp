@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Operation statistics for MyContainer.
+//
+// Define MYCONTAINER_ENABLE_STATS to 1 before including MyContainer.hpp to
+// count operations. Otherwise the recorder is an empty base class whose hooks
+// are empty inline functions, so instrumented call sites compile to nothing
+// and add no size to the container.
+#ifndef MYCONTAINER_ENABLE_STATS
+#define MYCONTAINER_ENABLE_STATS 0
+#endif
+
+namespace myns {
+
+// Order types whose construction is counted
+enum class OrderKind {
+    Ascending,
+    Descending,
+    SideCross,
+    Reverse,
+    Order,
+    MiddleOut,
+    GroupedAscending,
+    Distinct,
+    Frequency,
+    Count  // Number of order types
+};
+
+// Snapshot of a container's operation counters
+struct ContainerStats {
+    uint64_t adds = 0;                  // Successful add() calls
+    uint64_t removes = 0;               // remove() calls that found the value
+    uint64_t remove_misses = 0;         // remove() calls that threw "Element not found"
+    uint64_t order_constructions[static_cast<size_t>(OrderKind::Count)] = {};  // Indexed by OrderKind
+    uint64_t elements_copied = 0;       // Elements copied into iterator scratch
+    uint64_t bytes_allocated = 0;       // Storage growth plus iterator scratch
+    uint64_t sorts = 0;                 // Sorts performed by iterators
+    uint64_t sort_ns = 0;               // Total time spent sorting
+    uint64_t flushes = 0;               // splice() calls (staging-buffer flushes)
+    uint64_t flushed_elements = 0;      // Elements moved in by splice()
+    uint64_t flush_ns = 0;              // Total time spent in splice()
+
+    uint64_t constructions(OrderKind kind) const { return order_constructions[static_cast<size_t>(kind)]; }
+};
+
+namespace detail {
+
+#if MYCONTAINER_ENABLE_STATS
+
+// Relaxed atomic counter that starts from zero again when copied
+class stat_counter {
+    std::atomic<uint64_t> value{0};
+
+public:
+    stat_counter() = default;
+    stat_counter(const stat_counter&) {}
+    stat_counter& operator=(const stat_counter&) { return *this; }
+
+    void add(uint64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t load() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+};
+
+// Counts container operations; hooks are const because orders are built from const containers
+class stats_recorder {
+    mutable stat_counter adds, removes, remove_misses, elements_copied, bytes_allocated, sorts, sort_ns;
+    mutable stat_counter flushes, flushed_elements, flush_ns;
+    mutable stat_counter constructions[static_cast<size_t>(OrderKind::Count)];
+
+public:
+    static constexpr bool stats_enabled = true;
+
+    // Records the time of one sort when it goes out of scope
+    class sort_timer {
+        const stats_recorder& rec;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    public:
+        explicit sort_timer(const stats_recorder& r) : rec(r) {}
+        ~sort_timer() {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            rec.sorts.add(1);
+            rec.sort_ns.add(static_cast<uint64_t>(ns.count()));
+        }
+    };
+
+    // Records one splice of `elements` elements and its time when it goes out of scope
+    class flush_timer {
+        const stats_recorder& rec;
+        uint64_t elements;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    public:
+        flush_timer(const stats_recorder& r, size_t n) : rec(r), elements(n) {}
+        ~flush_timer() {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            rec.flushes.add(1);
+            rec.flushed_elements.add(elements);
+            rec.flush_ns.add(static_cast<uint64_t>(ns.count()));
+        }
+    };
+
+protected:
+    void stat_add(size_t old_capacity, size_t new_capacity, size_t element_size) const {
+        adds.add(1);
+        if (new_capacity != old_capacity) bytes_allocated.add(new_capacity * element_size);
+    }
+    void stat_remove() const { removes.add(1); }
+    void stat_remove_miss() const { remove_misses.add(1); }
+
+    // An order was constructed, copying `copied` elements of `element_size` bytes into scratch
+    void stat_order(OrderKind kind, size_t copied, size_t element_size) const {
+        constructions[static_cast<size_t>(kind)].add(1);
+        elements_copied.add(copied);
+        bytes_allocated.add(copied * element_size);
+    }
+
+    sort_timer stat_sort() const { return sort_timer(*this); }
+    flush_timer stat_flush(size_t elements) const { return flush_timer(*this, elements); }
+
+    // Storage grew outside add()
+    void stat_grow(size_t old_capacity, size_t new_capacity, size_t element_size) const {
+        if (new_capacity != old_capacity) bytes_allocated.add(new_capacity * element_size);
+    }
+
+public:
+    ContainerStats stats() const {
+        ContainerStats s;
+        s.adds = adds.load();
+        s.removes = removes.load();
+        s.remove_misses = remove_misses.load();
+        for (size_t i = 0; i < static_cast<size_t>(OrderKind::Count); ++i) {
+            s.order_constructions[i] = constructions[i].load();
+        }
+        s.elements_copied = elements_copied.load();
+        s.bytes_allocated = bytes_allocated.load();
+        s.sorts = sorts.load();
+        s.sort_ns = sort_ns.load();
+        s.flushes = flushes.load();
+        s.flushed_elements = flushed_elements.load();
+        s.flush_ns = flush_ns.load();
+        return s;
+    }
+
+    void reset_stats() {
+        adds.reset();
+        removes.reset();
+        remove_misses.reset();
+        for (auto& c : constructions) c.reset();
+        elements_copied.reset();
+        bytes_allocated.reset();
+        sorts.reset();
+        sort_ns.reset();
+        flushes.reset();
+        flushed_elements.reset();
+        flush_ns.reset();
+    }
+};
+
+#else
+
+// Statistics compiled out: every hook is an empty inline function
+class stats_recorder {
+public:
+    static constexpr bool stats_enabled = false;
+
+    struct sort_timer {};
+    struct flush_timer {};
+
+protected:
+    void stat_add(size_t, size_t, size_t) const {}
+    void stat_remove() const {}
+    void stat_remove_miss() const {}
+    void stat_order(OrderKind, size_t, size_t) const {}
+    sort_timer stat_sort() const { return {}; }
+    flush_timer stat_flush(size_t) const { return {}; }
+    void stat_grow(size_t, size_t, size_t) const {}
+
+public:
+    ContainerStats stats() const { return {}; }  // Always zero
+    void reset_stats() {}
+};
+
+#endif
+
+} // namespace detail
+} // namespace myns
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Epoch-based reclamation for read-mostly data.
+//
+// A reader wraps its accesses in an epoch::Guard, which announces the global
+// epoch in a slot owned by the reader's thread. Slots sit on their own cache
+// lines, so entering and leaving a guard only writes memory no other thread
+// writes. A writer that unlinks an object retires it with the current epoch
+// and advances the epoch; the object may be freed once no thread is still
+// inside a guard that started at or before that epoch.
+
+namespace myns {
+namespace epoch {
+
+// Announced by threads that are not inside a guard
+constexpr uint64_t idle = std::numeric_limits<uint64_t>::max();
+
+namespace detail {
+
+// One thread's announcement, padded to a cache line
+struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch{idle};  // Epoch the owner entered its outermost guard in
+    std::atomic<bool> owned{true};      // False once the owner thread exits; the slot is then reused
+    size_t depth = 0;                   // Guard nesting; only the owner touches it
+};
+
+// Every slot ever handed out; slots are reused but never freed, so readers of
+// the list only need the lock to see a consistent vector
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::atomic<uint64_t> global{1};
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Claims a free slot, or adds one (the only locked step of the reader path)
+inline Slot* acquire_slot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& s : r.slots) {
+        bool expected = false;
+        if (s->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) return s.get();
+    }
+    r.slots.push_back(std::make_unique<Slot>());
+    return r.slots.back().get();
+}
+
+// The calling thread's slot, released for reuse when the thread exits
+inline Slot& local_slot() {
+    struct Handle {
+        Slot* slot = acquire_slot();
+        ~Handle() { slot->owned.store(false, std::memory_order_release); }
+    };
+    thread_local Handle handle;
+    return *handle.slot;
+}
+
+} // namespace detail
+
+// Current global epoch
+inline uint64_t current() {
+    return detail::registry().global.load(std::memory_order_acquire);
+}
+
+// Advances the global epoch and returns the epoch that just ended
+inline uint64_t advance() {
+    return detail::registry().global.fetch_add(1, std::memory_order_seq_cst);
+}
+
+// Oldest epoch a thread is still reading in, or idle when no thread is in a guard
+inline uint64_t oldest_active() {
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t oldest = idle;
+    for (const auto& s : r.slots) oldest = std::min(oldest, s->epoch.load(std::memory_order_seq_cst));
+    return oldest;
+}
+
+//
+// Guard - marks the calling thread as reading for its lifetime. Nested guards
+// on one thread keep the epoch of the outermost one.
+//
+class Guard {
+    detail::Slot& slot;
+
+public:
+    Guard() : slot(detail::local_slot()) {
+        if (slot.depth++ == 0) {
+            slot.epoch.store(current(), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);  // Announce before reading shared pointers
+        }
+    }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    ~Guard() {
+        if (--slot.depth == 0) slot.epoch.store(idle, std::memory_order_release);
+    }
+};
+
+} // namespace epoch
+} // namespace myns
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <thread>
+
+#include "ContainerStats.hpp"
+
+// Latency histograms for MyContainer operations.
+//
+// Define MYCONTAINER_ENABLE_LATENCY to 1 before including MyContainer.hpp to
+// time add(), remove() and the construction of every order. Otherwise the
+// recorder is an empty base class and the timing scopes compile to nothing.
+#ifndef MYCONTAINER_ENABLE_LATENCY
+#define MYCONTAINER_ENABLE_LATENCY 0
+#endif
+
+namespace myns {
+
+//
+// LatencyHistogram - HDR-style log-bucketed histogram of nanosecond latencies.
+// Values below 16ns are counted exactly; above that every power of two is split
+// into 8 linear sub-buckets, bounding the relative error at 12.5%. Writers
+// increment relaxed atomics in a cache-line-aligned stripe, and readers merge
+// the stripes. There is one stripe per hardware thread, up to max_stripes,
+// handed to threads round-robin in the order they first record, so threads
+// that start together get stripes of their own. Stripes are shared, and
+// contended, once more threads have recorded than there are stripes. Each
+// stripe takes about 2.5 KiB, which bounds a histogram at about 40 KiB.
+//
+class LatencyHistogram {
+public:
+    static constexpr size_t linear_limit = 16;     // Values below this get their own bucket
+    static constexpr unsigned sub_bucket_bits = 3;  // 8 sub-buckets per power of two
+    static constexpr unsigned max_exponent = 40;   // Values from 2^40 ns (~18 min) share the last bucket
+    static constexpr size_t bucket_count = linear_limit + (max_exponent - 4) * (size_t(1) << sub_bucket_bits);
+    static constexpr size_t max_stripes = 16;      // Caps the footprint on machines with many hardware threads
+
+    // Percentile summary of a histogram
+    struct Summary {
+        uint64_t count = 0;
+        double mean_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p90_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t p999_ns = 0;
+        uint64_t max_ns = 0;
+    };
+
+    LatencyHistogram() : num_stripes(std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), max_stripes)),
+                         stripes(new Stripe[num_stripes]) {}
+
+    size_t stripe_count() const { return num_stripes; }  // One per hardware thread, up to max_stripes
+    size_t footprint_bytes() const { return num_stripes * sizeof(Stripe); }  // Heap held by the stripes
+
+    // Index of the bucket holding value
+    static size_t bucket_index(uint64_t value) {
+        if (value < linear_limit) return static_cast<size_t>(value);
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        if (exponent >= max_exponent) return bucket_count - 1;
+        size_t sub = (value >> (exponent - sub_bucket_bits)) & ((size_t(1) << sub_bucket_bits) - 1);
+        return linear_limit + (exponent - 4) * (size_t(1) << sub_bucket_bits) + sub;
+    }
+
+    // Largest value that maps to bucket i
+    static uint64_t bucket_upper(size_t i) {
+        if (i < linear_limit) return i;
+        size_t offset = i - linear_limit;
+        unsigned exponent = static_cast<unsigned>(offset >> sub_bucket_bits) + 4;
+        uint64_t sub = offset & ((size_t(1) << sub_bucket_bits) - 1);
+        uint64_t width = uint64_t(1) << (exponent - sub_bucket_bits);
+        return (((uint64_t(1) << sub_bucket_bits) + sub) * width) + width - 1;
+    }
+
+    void record(uint64_t ns) {
+        Stripe& s = stripes[thread_ticket() % num_stripes];
+        s.counts[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        s.total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t seen = s.max_ns.load(std::memory_order_relaxed);
+        while (ns > seen && !s.max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+    }
+
+    // Merges the stripes and computes percentiles (each reported as its bucket's upper bound)
+    Summary summary() const {
+        uint64_t merged[bucket_count] = {};
+        Summary out;
+        uint64_t total_ns = 0;
+        for (size_t k = 0; k < num_stripes; ++k) {
+            const Stripe& s = stripes[k];
+            for (size_t i = 0; i < bucket_count; ++i) merged[i] += s.counts[i].load(std::memory_order_relaxed);
+            total_ns += s.total_ns.load(std::memory_order_relaxed);
+            out.max_ns = std::max(out.max_ns, s.max_ns.load(std::memory_order_relaxed));
+        }
+        for (uint64_t c : merged) out.count += c;
+        if (out.count == 0) return out;
+
+        out.mean_ns = static_cast<double>(total_ns) / out.count;
+        auto percentile = [&](double q) {
+            uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * out.count)));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; ++i) {
+                seen += merged[i];
+                if (seen >= rank) return std::min(bucket_upper(i), out.max_ns);
+            }
+            return out.max_ns;
+        };
+        out.p50_ns = percentile(0.50);
+        out.p90_ns = percentile(0.90);
+        out.p99_ns = percentile(0.99);
+        out.p999_ns = percentile(0.999);
+        return out;
+    }
+
+    void reset() {
+        for (size_t k = 0; k < num_stripes; ++k) {
+            Stripe& s = stripes[k];
+            for (auto& c : s.counts) c.store(0, std::memory_order_relaxed);
+            s.total_ns.store(0, std::memory_order_relaxed);
+            s.max_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> counts[bucket_count] = {};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+    };
+
+    const size_t num_stripes;
+    std::unique_ptr<Stripe[]> stripes;
+
+    // Numbers threads in the order they first record, so consecutive threads
+    // land on different stripes; each thread always writes to the same stripe
+    static size_t thread_ticket() {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+        return ticket;
+    }
+};
+
+// Operations with a latency histogram: add, remove and the construction of each order
+enum class LatencyOp {
+    Add,
+    Remove,
+    Ascending,
+    Descending,
+    SideCross,
+    Reverse,
+    Order,
+    MiddleOut,
+    GroupedAscending,
+    Distinct,
+    Frequency,
+    Splice,
+    Count  // Number of operations
+};
+
+// Latency operation that times the construction of an order
+constexpr LatencyOp latency_op(OrderKind kind) {
+    return static_cast<LatencyOp>(static_cast<size_t>(kind) + 2);
+}
+
+static_assert(static_cast<size_t>(LatencyOp::Splice) == static_cast<size_t>(OrderKind::Count) + 2,
+              "LatencyOp must list add, remove and every OrderKind, then splice");
+
+inline const char* latency_op_name(LatencyOp op) {
+    static const char* const names[] = {"add", "remove", "ascending_order", "descending_order",
+                                        "sidecross_order", "reverse_order", "order", "middle_out_order",
+                                        "grouped_ascending_order", "distinct_order", "frequency_order", "splice"};
+    return names[static_cast<size_t>(op)];
+}
+
+namespace detail {
+
+#if MYCONTAINER_ENABLE_LATENCY
+
+// Owns one lazily allocated histogram per operation
+class latency_recorder {
+    static constexpr size_t op_count = static_cast<size_t>(LatencyOp::Count);
+    mutable std::atomic<LatencyHistogram*> histograms[op_count] = {};
+
+    LatencyHistogram& histogram(LatencyOp op) const {
+        auto& slot = histograms[static_cast<size_t>(op)];
+        LatencyHistogram* h = slot.load(std::memory_order_acquire);
+        if (h) return *h;
+        LatencyHistogram* fresh = new LatencyHistogram();
+        if (slot.compare_exchange_strong(h, fresh, std::memory_order_acq_rel)) return *fresh;
+        delete fresh;  // Another thread installed one first
+        return *h;
+    }
+
+public:
+    static constexpr bool latency_enabled = true;
+
+    // Records the lifetime of the scope into the operation's histogram
+    class latency_scope {
+        const latency_recorder& rec;
+        LatencyOp op;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    public:
+        latency_scope(const latency_recorder& r, LatencyOp o) : rec(r), op(o) {}
+        ~latency_scope() {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            rec.histogram(op).record(static_cast<uint64_t>(ns.count()));
+        }
+    };
+
+    latency_recorder() = default;
+    latency_recorder(const latency_recorder&) {}  // Copies start with empty histograms
+    latency_recorder& operator=(const latency_recorder&) { return *this; }
+    ~latency_recorder() {
+        for (auto& slot : histograms) delete slot.load(std::memory_order_relaxed);
+    }
+
+protected:
+    latency_scope time_op(LatencyOp op) const { return latency_scope(*this, op); }
+
+public:
+    LatencyHistogram::Summary latency(LatencyOp op) const {
+        LatencyHistogram* h = histograms[static_cast<size_t>(op)].load(std::memory_order_acquire);
+        return h ? h->summary() : LatencyHistogram::Summary{};
+    }
+
+    // Prints one line of percentiles per operation that has been timed
+    void dump_latency(std::ostream& os) const {
+        for (size_t i = 0; i < op_count; ++i) {
+            LatencyHistogram::Summary s = latency(static_cast<LatencyOp>(i));
+            if (s.count == 0) continue;
+            os << latency_op_name(static_cast<LatencyOp>(i)) << ": count=" << s.count << " mean=" << s.mean_ns
+               << "ns p50=" << s.p50_ns << "ns p90=" << s.p90_ns << "ns p99=" << s.p99_ns
+               << "ns p99.9=" << s.p999_ns << "ns max=" << s.max_ns << "ns\n";
+        }
+    }
+
+    void reset_latency() {
+        for (auto& slot : histograms) {
+            if (LatencyHistogram* h = slot.load(std::memory_order_acquire)) h->reset();
+        }
+    }
+};
+
+#else
+
+// Latency histograms compiled out: timing scopes are empty objects
+class latency_recorder {
+public:
+    static constexpr bool latency_enabled = false;
+
+    struct latency_scope {};
+
+protected:
+    latency_scope time_op(LatencyOp) const { return {}; }
+
+public:
+    LatencyHistogram::Summary latency(LatencyOp) const { return {}; }  // Always empty
+    void dump_latency(std::ostream&) const {}
+    void reset_latency() {}
+};
+
+#endif
+
+} // namespace detail
+} // namespace myns
@@ -5,13 +5,405 @@
 #include <algorithm>
 #include <stdexcept>
 #include <numeric>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <iterator>
+
+#include "ContainerStats.hpp"
+#include "LatencyHistogram.hpp"
+#include "SortTraits.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 
 namespace myns {
 
+// ========================== PARALLEL HELPERS ==========================
+
+namespace detail {
+
+// Orders over at least this many elements copy, reverse and arrange their
+// scratch on ThreadPool::shared(); smaller ones stay on the calling thread
+constexpr size_t parallel_min_elements = size_t(1) << 17;
+
+// Bytes per chunk handed to one thread, sized to stay in a core's L2 cache
+constexpr size_t parallel_chunk_bytes = size_t(64) << 10;
+
+template<typename T>
+constexpr size_t parallel_chunk() {
+    return std::max<size_t>(1, parallel_chunk_bytes / sizeof(T));
+}
+
+// Element-wise parallel work needs default-constructible T to size the output up front
+template<typename T>
+constexpr bool parallel_build(size_t n) {
+    return n >= parallel_min_elements && std::is_default_constructible<T>::value;
+}
+
+// Copy of src, made in chunks on the pool for large inputs
+template<typename T>
+std::vector<T> copy_of(const std::vector<T>& src) {
+    if constexpr (std::is_default_constructible<T>::value) {
+        if (parallel_build<T>(src.size())) {
+            std::vector<T> out(src.size());
+            ThreadPool::shared().parallel_for(src.size(), parallel_chunk<T>(), [&](size_t begin, size_t end) {
+                std::copy(src.begin() + begin, src.begin() + end, out.begin() + begin);
+            });
+            return out;
+        }
+    }
+    return src;
+}
+
+// Returns out with out[j] = src[index(j)] for every j < src.size()
+template<typename T, typename Index>
+std::vector<T> gather(const std::vector<T>& src, Index index) {
+    const size_t n = src.size();
+    std::vector<T> out;
+    if constexpr (std::is_default_constructible<T>::value) {
+        if (parallel_build<T>(n)) {
+            out.resize(n);
+            ThreadPool::shared().parallel_for(n, parallel_chunk<T>(), [&](size_t begin, size_t end) {
+                for (size_t j = begin; j < end; ++j) out[j] = src[index(j)];
+            });
+            return out;
+        }
+    }
+    out.reserve(n);  // One allocation for the arranged copy
+    for (size_t j = 0; j < n; ++j) out.push_back(src[index(j)]);
+    return out;
+}
+
+// Reverses v in place; large inputs swap mirrored chunks on the pool
+template<typename T>
+void reverse(std::vector<T>& v) {
+    const size_t half = v.size() / 2;
+    if (v.size() < parallel_min_elements) {
+        std::reverse(v.begin(), v.end());
+        return;
+    }
+    ThreadPool::shared().parallel_for(half, parallel_chunk<T>(), [&v](size_t begin, size_t end) {
+        using std::swap;
+        for (size_t i = begin; i < end; ++i) swap(v[i], v[v.size() - 1 - i]);
+    });
+}
+
+} // namespace detail
+
+// ========================== SORTING HELPERS ==========================
+
+namespace detail {
+
+// Sorts a vector in ascending order with the backend sort_traits<T> selects
+template<typename T>
+void sort_ascending(std::vector<T>& v) {
+    sort_backend_t<T>::sort(v);
+}
+
+// Sorts a vector in descending order: the ascending order, reversed
+template<typename T>
+void sort_descending(std::vector<T>& v) {
+    sort_ascending(v);
+    reverse(v);
+}
+
+// How many elements ahead pointer traversals prefetch
+constexpr size_t prefetch_distance = 8;
+
+// Issues a software prefetch for the object that v[i] points to (pointer element types only)
+template<typename T>
+inline void prefetch_pointee(const std::vector<T>& v, size_t i) {
+    if constexpr (std::is_pointer<T>::value && std::is_object<std::remove_pointer_t<T>>::value) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (i < v.size()) __builtin_prefetch(static_cast<const void*>(v[i]));
+#else
+        (void)v;
+        (void)i;
+#endif
+    }
+}
+
+// True when std::hash<T> is usable
+template<typename T, typename = void>
+struct is_hashable : std::false_type {};
+
+template<typename T>
+struct is_hashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+
+// Collapses equal elements into (value, count) groups in no particular order.
+// Hashable types are aggregated in a hash map in O(n); other types fall back
+// to sort + run-length counting.
+template<typename T>
+std::vector<std::pair<T, size_t>> count_values(const std::vector<T>& v) {
+    std::vector<std::pair<T, size_t>> groups;
+    if constexpr (is_hashable<T>::value) {
+        std::unordered_map<T, size_t> counts;
+        for (const T& x : v) ++counts[x];
+
+        groups.reserve(counts.size());
+        for (auto& entry : counts) groups.emplace_back(entry.first, entry.second);
+    } else {
+        std::vector<T> sorted = v;
+        sort_ascending(sorted);
+        for (T& x : sorted) {
+            if (!groups.empty() && groups.back().first == x) ++groups.back().second;
+            else groups.emplace_back(std::move(x), 1);
+        }
+    }
+    return groups;
+}
+
+// Collapses equal elements into (value, count) groups sorted ascending.
+// Only the distinct values are sorted, so the cost scales with their number.
+template<typename T>
+std::vector<std::pair<T, size_t>> group_ascending(const std::vector<T>& v) {
+    std::vector<std::pair<T, size_t>> groups = count_values(v);
+    if constexpr (is_hashable<T>::value) {
+        std::sort(groups.begin(), groups.end(),
+                  [](const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) { return a.first < b.first; });
+    }
+    return groups;
+}
+
+// Returns the top_k most frequent (value, count) groups, most common first.
+// Equal counts are ordered by ascending value. nth_element picks the top_k
+// groups in linear time and only those are sorted, so the cost is O(n + k log k).
+template<typename T>
+std::vector<std::pair<T, size_t>> group_by_frequency(const std::vector<T>& v, size_t top_k) {
+    std::vector<std::pair<T, size_t>> groups = count_values(v);
+    const size_t k = std::min(top_k, groups.size());
+    auto more_common = [](const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    };
+    std::nth_element(groups.begin(), groups.begin() + k, groups.end(), more_common);
+    std::sort(groups.begin(), groups.begin() + k, more_common);
+    groups.erase(groups.begin() + k, groups.end());
+    return groups;
+}
+
+// True when F compares two T values (a comparator) rather than mapping one T to a key (a projection)
+template<typename F, typename T>
+using is_comparator = std::is_invocable_r<bool, F&, const T&, const T&>;
+
+// Sorts a vector by a user-supplied comparator or projection.
+// A projection is evaluated once per element (decorate-sort-undecorate),
+// and elements with equal keys keep their insertion order.
+template<typename T, typename F>
+void sort_by(std::vector<T>& v, F f, bool descending) {
+    if constexpr (is_comparator<F, T>::value) {
+        if (descending) {
+            std::sort(v.begin(), v.end(), [&f](const T& a, const T& b) { return std::invoke(f, b, a); });
+        } else {
+            std::sort(v.begin(), v.end(), [&f](const T& a, const T& b) { return std::invoke(f, a, b); });
+        }
+    } else {
+        static_assert(std::is_invocable<F&, const T&>::value,
+                      "F must be a comparator (T, T) -> bool or a projection T -> key");
+        using Key = std::decay_t<std::invoke_result_t<F&, const T&>>;
+        static_assert(std::is_same<decltype(std::declval<Key>() < std::declval<Key>()), bool>::value,
+                      "Projected key must support operator< returning bool");
+
+        // Decorate: compute every key exactly once
+        std::vector<std::pair<Key, size_t>> keyed;
+        keyed.reserve(v.size());
+        for (size_t i = 0; i < v.size(); ++i) {
+            prefetch_pointee(v, i + prefetch_distance);  // Warm up upcoming pointees
+            keyed.emplace_back(std::invoke(f, v[i]), i);
+        }
+
+        // Sort on the keys, breaking ties by original position
+        std::sort(keyed.begin(), keyed.end(),
+                  [descending](const std::pair<Key, size_t>& a, const std::pair<Key, size_t>& b) {
+            if (a.first < b.first) return !descending;
+            if (b.first < a.first) return descending;
+            return a.second < b.second;
+        });
+
+        // Undecorate: move elements into their sorted positions
+        std::vector<T> result;
+        result.reserve(v.size());
+        for (const auto& k : keyed) result.push_back(std::move(v[k.second]));
+        v.swap(result);
+    }
+}
+
+// ========================== MEMORY ACCOUNTING ==========================
+
+// Heap bytes owned by an element outside the container's own storage
+template<typename T>
+size_t heap_bytes(const T&) {
+    return 0;
+}
+
+// A std::string owns heap memory unless its characters live in the small-string buffer
+inline size_t heap_bytes(const std::string& s) {
+    const char* chars = s.data();
+    const char* self = reinterpret_cast<const char*>(&s);
+    const bool inline_buffer = chars >= self && chars < self + sizeof(s);
+    return inline_buffer ? 0 : s.capacity() + 1;
+}
+
+// Byte total of live iterator scratch, reference counted by its container and
+// by every charging iterator, so one that outlives its container still has a
+// counter to release into
+class scratch_counter {
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> refs{1};  // The creator holds the first reference
+
+public:
+    void add(size_t n) { bytes.fetch_add(n, std::memory_order_relaxed); }
+    void sub(size_t n) { bytes.fetch_sub(n, std::memory_order_relaxed); }
+    size_t load() const { return bytes.load(std::memory_order_relaxed); }
+
+    void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+};
+
+// Held by an iterator: charges its scratch bytes to the container while the
+// iterator (or any copy of it) is alive
+class scratch_account {
+    scratch_counter* counter = nullptr;
+    size_t bytes = 0;
+
+    void charge() {
+        if (!counter) return;
+        counter->retain();
+        counter->add(bytes);
+    }
+
+    void discharge() {
+        if (!counter) return;
+        counter->sub(bytes);
+        counter->release();
+    }
+
+public:
+    scratch_account() = default;
+    scratch_account(scratch_counter& c, size_t n) : counter(&c), bytes(n) { charge(); }
+    scratch_account(const scratch_account& other) : counter(other.counter), bytes(other.bytes) { charge(); }
+    scratch_account& operator=(const scratch_account& other) {
+        if (this != &other) {
+            discharge();
+            counter = other.counter;
+            bytes = other.bytes;
+            charge();
+        }
+        return *this;
+    }
+    ~scratch_account() { discharge(); }
+};
+
+// Elements an arranged order yields. The order and its begin()/end() copies
+// share one, so copying an iterator is O(1), and its scratch is charged to
+// the container once.
+template<typename V>
+struct arranged_values {
+    std::vector<V> values;
+    scratch_account account;
+};
+
+template<typename V>
+std::shared_ptr<const arranged_values<V>> share_arranged(std::vector<V> values, scratch_counter& counter) {
+    auto shared = std::make_shared<arranged_values<V>>();
+    shared->values = std::move(values);
+    shared->account = scratch_account(counter, shared->values.capacity() * sizeof(V));
+    return shared;
+}
+
+} // namespace detail
+
+// Memory used by a container, in bytes. Storage that a write has detached
+// from, but that a snapshot or an Order/ReverseOrder still pins, belongs to
+// those holders and is not counted here.
+struct MemoryUsage {
+    size_t storage_bytes = 0;           // Live elements: size() * sizeof(T)
+    size_t slack_bytes = 0;             // Spare capacity: (capacity - size) * sizeof(T)
+    size_t iterator_scratch_bytes = 0;  // Buffers held by live order iterators
+    size_t element_heap_bytes = 0;      // Out-of-line heap memory owned by elements (e.g. long std::string)
+
+    size_t total() const {
+        return storage_bytes + slack_bytes + iterator_scratch_bytes + element_heap_bytes;
+    }
+};
+
+// Projection that orders pointer elements by the value they point to, e.g.
+// container.ascending_order(myns::by_pointee). Throws on null pointers.
+struct by_pointee_t {
+    template<typename P>
+    const auto& operator()(const P& p) const {
+        if (p == nullptr) throw std::runtime_error("Null pointer in pointee order");
+        return *p;
+    }
+};
+
+inline constexpr by_pointee_t by_pointee{};
+
+//
+// OrderSlice - positions [first, last) of an order, without copying elements.
+// It walks like the orders do (begin(), end(), operator*, operator++) and is
+// index-addressable too. It points into the order, which must outlive it.
+//
+template<typename Order>
+class OrderSlice {
+    const Order* order;
+    size_t first;
+    size_t last;
+    size_t pos;
+
+public:
+    OrderSlice(const Order& o, size_t first_pos, size_t last_pos)
+        : order(&o), first(first_pos), last(last_pos), pos(first_pos) {}
+
+    // Slice i of k near-equal slices of the whole order; the first n % k slices get one extra element
+    OrderSlice(const Order& o, size_t i, size_t k, size_t n) : order(&o), first(0), last(0), pos(0) {
+        if (k == 0) throw std::invalid_argument("OrderSlice needs at least one chunk");
+        if (i >= k) throw std::out_of_range("OrderSlice chunk index out of range");
+        first = n / k * i + std::min(i, n % k);
+        last = first + n / k + (i < n % k ? 1 : 0);
+        pos = first;
+    }
+
+    const auto& operator*() const {
+        if (pos >= last) throw std::out_of_range("OrderSlice dereference out of bounds");
+        return (*order)[pos];
+    }
+
+    OrderSlice& operator++() { ++pos; return *this; }
+    bool operator==(const OrderSlice& other) const { return pos == other.pos; }
+    bool operator!=(const OrderSlice& other) const { return !(*this == other); }
+    OrderSlice begin() const { OrderSlice it = *this; it.pos = first; return it; }
+    OrderSlice end() const { OrderSlice it = *this; it.pos = last; return it; }
+    size_t size() const { return last - first; }
+    const auto& operator[](size_t i) const { return (*order)[first + i]; }  // i-th element of the slice, unchecked
+    size_t offset() const { return first; }  // Position of the slice's first element in the order
+};
+
+// The k slices of an order, in position order
+template<typename Order>
+std::vector<OrderSlice<Order>> split_order(const Order& order, size_t k) {
+    if (k == 0) throw std::invalid_argument("OrderSlice needs at least one chunk");
+    std::vector<OrderSlice<Order>> slices;
+    slices.reserve(k);
+    for (size_t i = 0; i < k; ++i) slices.emplace_back(order, i, k, order.size());
+    return slices;
+}
+
 template<typename T = int>
-class MyContainer {
+class MyContainer : private detail::stats_recorder, private detail::latency_recorder {
 private:
-    std::vector<T> data;  // Internal storage for elements
+    std::shared_ptr<std::vector<T>> data;  // Element storage, shared copy-on-write with snapshots
+    double growth = 2.0;  // Capacity multiplier when data is full
+    mutable std::atomic<detail::scratch_counter*> scratch{nullptr};  // Live iterator scratch bytes; copies start without one
+    mutable std::atomic<bool> shared{false};  // Set once a copy may share data, so writes check the owner count
 
     // --- STATIC ASSERTS: enforce required traits for T at compile-time ---
 
@@ -45,12 +437,40 @@ private:
 
 public:
     MyContainer();                             // Default constructor
+    explicit MyContainer(std::vector<T> values);  // Takes over values, in order
+    MyContainer(const MyContainer& other);             // Shares storage (copy-on-write); moves copy too,
+    MyContainer& operator=(const MyContainer& other);  // so a moved-from container stays valid
+    ~MyContainer();
     void add(const T& value);                  // Add element
     void remove(const T& value);               // Remove element(s)
+    void splice(std::vector<T>& values);       // Move values to the end in one bulk step; leaves values empty
     size_t size() const;                       // Return number of elements
     const std::vector<T>& get_data() const;    // Access underlying vector
-
-    // Access individual elements
+    MyContainer snapshot() const;              // O(1) copy sharing storage until the next write
+
+    // Memory footprint and slack control
+    MemoryUsage memory_usage() const;          // Report bytes used by storage, slack, iterators and elements
+    void shrink_to_fit();                      // Release spare capacity
+    void set_growth_factor(double factor);     // Capacity multiplier on reallocation (> 1, default 2)
+    double growth_factor() const;
+
+    // Operation statistics (see ContainerStats.hpp); all zero unless
+    // MYCONTAINER_ENABLE_STATS is defined to 1
+    using detail::stats_recorder::stats;
+    using detail::stats_recorder::reset_stats;
+    using detail::stats_recorder::stats_enabled;
+
+    // Latency histograms (see LatencyHistogram.hpp); empty unless
+    // MYCONTAINER_ENABLE_LATENCY is defined to 1
+    using detail::latency_recorder::latency;
+    using detail::latency_recorder::dump_latency;
+    using detail::latency_recorder::reset_latency;
+    using detail::latency_recorder::latency_enabled;
+
+    // Access individual elements. The non-const overloads detach from any
+    // snapshot when called, but the reference they return points into the
+    // storage: after a later snapshot(), a write through it shows up in the
+    // snapshot too. Take such references after the snapshot, not before.
     const T& at(size_t index) const;
     T& at(size_t index);
     const T& operator[](size_t index) const;
@@ -63,6 +483,9 @@ public:
     class ReverseOrder;
     class Order;
     class MiddleOutOrder;
+    class GroupedAscendingOrder;
+    class DistinctOrder;
+    class FrequencyOrder;
 
     // Accessors to iterators
     AscendingOrder ascending_order() const;
@@ -71,6 +494,49 @@ public:
     ReverseOrder reverse_order() const;
     Order order() const;
     MiddleOutOrder middle_out_order() const;
+    GroupedAscendingOrder grouped_ascending_order() const;
+    DistinctOrder distinct_order() const;
+    FrequencyOrder frequency_order(size_t top_k = std::numeric_limits<size_t>::max()) const;
+
+    // Sorted iterators ordered by a comparator (T, T) -> bool or a projection T -> key
+    template<typename Compare> AscendingOrder ascending_order(Compare comp) const;
+    template<typename Compare> DescendingOrder descending_order(Compare comp) const;
+    template<typename Compare> SideCrossOrder sidecross_order(Compare comp) const;
+
+private:
+    // Latency and trace scopes around one operation
+    struct OpScope {
+        detail::latency_recorder::latency_scope latency;
+        trace::Scope trace;
+    };
+
+    // Stats timer and trace scope around one sort
+    struct SortScope {
+        detail::stats_recorder::sort_timer stats;
+        trace::Scope trace;
+    };
+
+    OpScope op_scope(LatencyOp op) const {
+        return {time_op(op), trace::Scope(latency_op_name(op), typeid(T), data->size())};
+    }
+
+    SortScope sort_scope() const {
+        return {stat_sort(), trace::Scope("sort", typeid(T), data->size())};
+    }
+
+    // Records that a copy, snapshot or pinning iterator may share the storage.
+    // Relaxed: readers on several threads may pin the same snapshot, which no
+    // thread writes. Pinning a container while another thread writes it races.
+    void mark_shared() const { shared.store(true, std::memory_order_relaxed); }
+
+    detail::scratch_counter& iterator_scratch() const;  // Created by the first order that needs it
+
+    // True when no snapshot or copy shares the storage
+    bool owns_data() const;
+
+    // Storage that is safe to write: copied first (with room for `capacity`
+    // elements) if a snapshot still shares it
+    std::vector<T>& writable_data(size_t capacity);
 };
 
 
@@ -78,62 +544,219 @@ public:
 
 // Constructor for the container - initializes an empty container
 template<typename T>
-MyContainer<T>::MyContainer() {}
+MyContainer<T>::MyContainer()
+    : data(std::make_shared<std::vector<T>>()), scratch(new detail::scratch_counter()) {}
+
+// Constructs a container holding the given elements in insertion order
+template<typename T>
+MyContainer<T>::MyContainer(std::vector<T> values)
+    : data(std::make_shared<std::vector<T>>(std::move(values))), scratch(new detail::scratch_counter()) {}
+
+// Copies share the storage; both sides copy it on their next write. A copy
+// counts its own iterator scratch, from a counter created by its first order,
+// so taking a snapshot still does not allocate.
+template<typename T>
+MyContainer<T>::MyContainer(const MyContainer& other)
+    : detail::stats_recorder(other), detail::latency_recorder(other),
+      data(other.data), growth(other.growth), shared(true) {
+    other.mark_shared();
+}
+
+template<typename T>
+MyContainer<T>::~MyContainer() {
+    if (detail::scratch_counter* counter = scratch.load(std::memory_order_acquire)) counter->release();
+}
+
+// The scratch counter, created on first use; orders built concurrently on a
+// const container agree on one through a CAS
+template<typename T>
+detail::scratch_counter& MyContainer<T>::iterator_scratch() const {
+    detail::scratch_counter* counter = scratch.load(std::memory_order_acquire);
+    if (counter) return *counter;
+    auto* fresh = new detail::scratch_counter();
+    if (scratch.compare_exchange_strong(counter, fresh, std::memory_order_acq_rel)) return *fresh;
+    fresh->release();  // Another order installed one first
+    return *counter;
+}
+
+template<typename T>
+MyContainer<T>& MyContainer<T>::operator=(const MyContainer& other) {
+    if (this != &other) {
+        detail::stats_recorder::operator=(other);
+        detail::latency_recorder::operator=(other);
+        data = other.data;
+        growth = other.growth;
+        mark_shared();
+        other.mark_shared();
+    }
+    return *this;
+}
+
+// A sole owner may write in place. Until a copy has been made this is a plain
+// flag test; afterwards the owner count decides, and the flag clears again
+// once the copies are gone. The acquire fence pairs with the release in
+// the last other owner's reference drop, so its reads finish before our writes.
+template<typename T>
+bool MyContainer<T>::owns_data() const {
+    if (!shared.load(std::memory_order_relaxed)) return true;
+    if (data.use_count() != 1) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    shared.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+// Detaches from any snapshot before a write
+template<typename T>
+std::vector<T>& MyContainer<T>::writable_data(size_t capacity) {
+    if (!owns_data()) {
+        auto fresh = std::make_shared<std::vector<T>>();
+        fresh->reserve(std::max(capacity, data->size()));
+        fresh->assign(data->begin(), data->end());
+        data = std::move(fresh);
+        shared.store(false, std::memory_order_relaxed);
+    }
+    return *data;
+}
 
 // Adds a new element to the container
 template<typename T>
 void MyContainer<T>::add(const T& value) {
-    data.push_back(value);
+    [[maybe_unused]] auto scope = op_scope(LatencyOp::Add);
+    const size_t old_capacity = data->capacity();
+    size_t capacity = old_capacity;
+    if (data->size() == old_capacity) {
+        // Grow by the configured factor instead of the standard library's choice
+        const size_t grown = static_cast<size_t>(static_cast<double>(old_capacity) * growth);
+        capacity = std::max(old_capacity + 1, grown);
+    }
+    if (!owns_data()) writable_data(capacity);  // A snapshot shares the storage: copy it with room to grow
+    else if (capacity != old_capacity) data->reserve(capacity);
+    data->push_back(value);
+    stat_add(old_capacity, data->capacity(), sizeof(T));
+}
+
+// Moves every element of values to the end, in order, growing the storage at
+// most once. values keeps its capacity, so a staging buffer can refill it
+// without allocating.
+template<typename T>
+void MyContainer<T>::splice(std::vector<T>& values) {
+    [[maybe_unused]] auto scope = op_scope(LatencyOp::Splice);
+    [[maybe_unused]] auto timer = stat_flush(values.size());
+    const size_t old_capacity = data->capacity();
+    const size_t needed = data->size() + values.size();
+    size_t capacity = old_capacity;
+    if (needed > old_capacity) {
+        const size_t grown = static_cast<size_t>(static_cast<double>(old_capacity) * growth);
+        capacity = std::max(needed, grown);
+    }
+    if (!owns_data()) writable_data(capacity);
+    else if (capacity != old_capacity) data->reserve(capacity);
+    data->insert(data->end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    values.clear();
+    stat_grow(old_capacity, data->capacity(), sizeof(T));
 }
 
 // Removes all occurrences of a given value from the container
 // Throws an exception if the element is not found
 template<typename T>
 void MyContainer<T>::remove(const T& value) {
+    [[maybe_unused]] auto scope = op_scope(LatencyOp::Remove);
     // Check if the value exists before attempting to remove it
-    if (std::find(data.begin(), data.end(), value) == data.end()) {
+    if (std::find(data->begin(), data->end(), value) == data->end()) {
+        stat_remove_miss();
         throw std::runtime_error("Element not found");
     }
 
-    // Remove all occurrences of the value
-    auto it = std::remove(data.begin(), data.end(), value);
-    data.erase(it, data.end());
+    // Remove all occurrences of the value; shared storage is filtered into a fresh copy
+    if (owns_data()) {
+        auto it = std::remove(data->begin(), data->end(), value);
+        data->erase(it, data->end());
+    } else {
+        auto fresh = std::make_shared<std::vector<T>>();
+        fresh->reserve(data->size());
+        std::remove_copy(data->begin(), data->end(), std::back_inserter(*fresh), value);
+        data = std::move(fresh);
+        shared.store(false, std::memory_order_relaxed);
+    }
+    stat_remove();
 }
 
 // Returns the number of elements in the container
 template<typename T>
 size_t MyContainer<T>::size() const {
-    return data.size();
+    return data->size();
 }
 
 // Provides read-only access to the underlying vector
 template<typename T>
 const std::vector<T>& MyContainer<T>::get_data() const {
-    return data;
+    return *data;
+}
+
+// Returns a copy that shares this container's storage; whichever side writes
+// next copies the elements first. Take it on the writing thread; the snapshot
+// and its orders can then be used from other threads while writes continue.
+// Building an order on the container itself (order() and reverse_order() pin
+// its storage) must not overlap a write to it from another thread.
+template<typename T>
+MyContainer<T> MyContainer<T>::snapshot() const {
+    return *this;
+}
+
+// Reports the bytes used by the container and by its live iterators
+template<typename T>
+MemoryUsage MyContainer<T>::memory_usage() const {
+    MemoryUsage usage;
+    usage.storage_bytes = data->size() * sizeof(T);
+    usage.slack_bytes = (data->capacity() - data->size()) * sizeof(T);
+    if (const detail::scratch_counter* counter = scratch.load(std::memory_order_acquire)) {
+        usage.iterator_scratch_bytes = counter->load();
+    }
+    for (const T& x : *data) usage.element_heap_bytes += detail::heap_bytes(x);
+    return usage;
+}
+
+// Releases spare capacity
+template<typename T>
+void MyContainer<T>::shrink_to_fit() {
+    writable_data(0).shrink_to_fit();
+}
+
+// Sets the capacity multiplier used when the container is full
+// Throws if the factor would not grow the storage
+template<typename T>
+void MyContainer<T>::set_growth_factor(double factor) {
+    if (!(factor > 1.0)) throw std::invalid_argument("Growth factor must be greater than 1");
+    growth = factor;
+}
+
+template<typename T>
+double MyContainer<T>::growth_factor() const {
+    return growth;
 }
 
 // Access element with bounds checking (read-only)
 template<typename T>
 const T& MyContainer<T>::at(size_t index) const {
-    return data.at(index);  // Will throw std::out_of_range if invalid
+    return data->at(index);  // Will throw std::out_of_range if invalid
 }
 
 // Access element with bounds checking (read-write)
 template<typename T>
 T& MyContainer<T>::at(size_t index) {
-    return data.at(index);
+    return writable_data(0).at(index);
 }
 
 // Access element without bounds checking (read-only)
 template<typename T>
 const T& MyContainer<T>::operator[](size_t index) const {
-    return data[index];  // No bounds check
+    return (*data)[index];  // No bounds check
 }
 
 // Access element without bounds checking (read-write)
 template<typename T>
 T& MyContainer<T>::operator[](size_t index) {
-    return data[index];  // No bounds check
+    return writable_data(0)[index];  // No bounds check
 }
 
 // Stream output operator for printing the container
@@ -156,25 +779,46 @@ std::ostream& operator<<(std::ostream& os, const MyContainer<T>& c) {
 template<typename T>
 class MyContainer<T>::AscendingOrder {
     const MyContainer& cont;     // Reference to the original container
-    std::vector<T> sorted;       // Copy of the container's data, sorted in ascending order
+    std::shared_ptr<const detail::arranged_values<T>> sorted;  // Copy of the container's data, sorted ascending
     size_t pos = 0;              // Current index in the sorted vector
 
 public:
     AscendingOrder(const MyContainer& c) : cont(c) {
-        sorted = c.get_data();                 // Copy data from container
-        std::sort(sorted.begin(), sorted.end()); // Sort ascending
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Ascending);
+        std::vector<T> values = detail::copy_of(c.get_data());  // Copy data from container
+        c.stat_order(OrderKind::Ascending, values.size(), sizeof(T));
+        [[maybe_unused]] auto timer = c.sort_scope();
+        detail::sort_ascending(values);        // Sort ascending
+        sorted = detail::share_arranged(std::move(values), c.iterator_scratch());
+    }
+
+    template<typename Compare>
+    AscendingOrder(const MyContainer& c, Compare comp) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Ascending);
+        std::vector<T> values = detail::copy_of(c.get_data());
+        c.stat_order(OrderKind::Ascending, values.size(), sizeof(T));
+        [[maybe_unused]] auto timer = c.sort_scope();
+        detail::sort_by(values, comp, false);  // Sort ascending by comparator or projection
+        sorted = detail::share_arranged(std::move(values), c.iterator_scratch());
     }
 
     const T& operator*() const {
-        if (pos >= sorted.size()) throw std::out_of_range("AscendingOrder dereference out of bounds");
-        return sorted[pos];                   // Return element at current position
+        if (pos >= sorted->values.size()) throw std::out_of_range("AscendingOrder dereference out of bounds");
+        detail::prefetch_pointee(sorted->values, pos + detail::prefetch_distance);  // Pointer types only
+        return sorted->values[pos];                   // Return element at current position
     }
 
     AscendingOrder& operator++() { ++pos; return *this; } // Move to next element
     bool operator==(const AscendingOrder& other) const { return pos == other.pos; } // Compare positions
     bool operator!=(const AscendingOrder& other) const { return !(*this == other); } // Negated equality
     AscendingOrder begin() const { return *this; } // Begin at position 0
-    AscendingOrder end() const { AscendingOrder it = *this; it.pos = sorted.size(); return it; } // End at size
+    AscendingOrder end() const { AscendingOrder it = *this; it.pos = sorted->values.size(); return it; } // End at size
+    size_t size() const { return sorted->values.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return sorted->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<AscendingOrder> chunk(size_t i, size_t k) const { return OrderSlice<AscendingOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<AscendingOrder>> split(size_t k) const { return split_order(*this, k); }
 };
 
 //
@@ -183,25 +827,46 @@ public:
 template<typename T>
 class MyContainer<T>::DescendingOrder {
     const MyContainer& cont;     // Reference to the container
-    std::vector<T> sorted;       // Sorted in descending order
+    std::shared_ptr<const detail::arranged_values<T>> sorted;  // Sorted in descending order
     size_t pos = 0;              // Current index
 
 public:
     DescendingOrder(const MyContainer& c) : cont(c) {
-        sorted = c.get_data();                               // Copy data
-        std::sort(sorted.begin(), sorted.end(), std::greater<T>()); // Sort descending
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Descending);
+        std::vector<T> values = detail::copy_of(c.get_data());  // Copy data
+        c.stat_order(OrderKind::Descending, values.size(), sizeof(T));
+        [[maybe_unused]] auto timer = c.sort_scope();
+        detail::sort_descending(values);       // Sort descending
+        sorted = detail::share_arranged(std::move(values), c.iterator_scratch());
+    }
+
+    template<typename Compare>
+    DescendingOrder(const MyContainer& c, Compare comp) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Descending);
+        std::vector<T> values = detail::copy_of(c.get_data());
+        c.stat_order(OrderKind::Descending, values.size(), sizeof(T));
+        [[maybe_unused]] auto timer = c.sort_scope();
+        detail::sort_by(values, comp, true);   // Sort descending by comparator or projection
+        sorted = detail::share_arranged(std::move(values), c.iterator_scratch());
     }
 
     const T& operator*() const {
-        if (pos >= sorted.size()) throw std::out_of_range("DescendingOrder dereference out of bounds");
-        return sorted[pos];
+        if (pos >= sorted->values.size()) throw std::out_of_range("DescendingOrder dereference out of bounds");
+        detail::prefetch_pointee(sorted->values, pos + detail::prefetch_distance);
+        return sorted->values[pos];
     }
 
     DescendingOrder& operator++() { ++pos; return *this; }
     bool operator==(const DescendingOrder& other) const { return pos == other.pos; }
     bool operator!=(const DescendingOrder& other) const { return !(*this == other); }
     DescendingOrder begin() const { return *this; }
-    DescendingOrder end() const { DescendingOrder it = *this; it.pos = sorted.size(); return it; }
+    DescendingOrder end() const { DescendingOrder it = *this; it.pos = sorted->values.size(); return it; }
+    size_t size() const { return sorted->values.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return sorted->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<DescendingOrder> chunk(size_t i, size_t k) const { return OrderSlice<DescendingOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<DescendingOrder>> split(size_t k) const { return split_order(*this, k); }
 };
 
 //
@@ -210,41 +875,60 @@ public:
 template<typename T>
 class MyContainer<T>::SideCrossOrder {
     const MyContainer& cont;     // Reference to container
-    std::vector<T> order;        // Elements arranged by side-cross logic
+    std::shared_ptr<const detail::arranged_values<T>> order;  // Elements arranged by side-cross logic
     size_t pos = 0;
 
 public:
     SideCrossOrder(const MyContainer& c) : cont(c) {
-        std::vector<T> sorted = c.get_data();  // Copy data
-        std::sort(sorted.begin(), sorted.end()); // Sort ascending
-        if (sorted.empty()) return;            // If empty, leave order empty
-
-        size_t left = 0;
-        size_t right = sorted.size() - 1;
-
-        // Alternate from both ends: left, right, next left, next right...
-        while (left <= right) {
-            if (left == right) {
-                order.push_back(sorted[left]); // Only one element left
-            } else {
-                order.push_back(sorted[left]);
-                order.push_back(sorted[right]);
-            }
-            ++left;
-            if (right > 0) --right;
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::SideCross);
+        std::vector<T> sorted = detail::copy_of(c.get_data());  // Copy data
+        c.stat_order(OrderKind::SideCross, 2 * sorted.size(), sizeof(T));  // Sorted copy + arranged copy
+        {
+            [[maybe_unused]] auto timer = c.sort_scope();
+            detail::sort_ascending(sorted);    // Sort ascending
+        }
+        build(sorted, c);
+    }
+
+    template<typename Compare>
+    SideCrossOrder(const MyContainer& c, Compare comp) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::SideCross);
+        std::vector<T> sorted = detail::copy_of(c.get_data());
+        c.stat_order(OrderKind::SideCross, 2 * sorted.size(), sizeof(T));
+        {
+            [[maybe_unused]] auto timer = c.sort_scope();
+            detail::sort_by(sorted, comp, false);  // Sort ascending by comparator or projection
         }
+        build(sorted, c);
+    }
+
+private:
+    // Arranges already-sorted elements in side-cross order:
+    // left, right, next left, next right...
+    void build(const std::vector<T>& sorted, const MyContainer& c) {
+        const size_t last = sorted.empty() ? 0 : sorted.size() - 1;
+        std::vector<T> arranged = detail::gather(sorted, [last](size_t j) { return j % 2 == 0 ? j / 2 : last - j / 2; });
+        order = detail::share_arranged(std::move(arranged), c.iterator_scratch());
     }
 
+public:
     const T& operator*() const {
-        if (pos >= order.size()) throw std::out_of_range("SideCrossOrder dereference out of bounds");
-        return order[pos];
+        if (pos >= order->values.size()) throw std::out_of_range("SideCrossOrder dereference out of bounds");
+        detail::prefetch_pointee(order->values, pos + detail::prefetch_distance);
+        return order->values[pos];
     }
 
     SideCrossOrder& operator++() { ++pos; return *this; }
     bool operator==(const SideCrossOrder& other) const { return pos == other.pos; }
     bool operator!=(const SideCrossOrder& other) const { return !(*this == other); }
     SideCrossOrder begin() const { return *this; }
-    SideCrossOrder end() const { SideCrossOrder it = *this; it.pos = order.size(); return it; }
+    SideCrossOrder end() const { SideCrossOrder it = *this; it.pos = order->values.size(); return it; }
+    size_t size() const { return order->values.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return order->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<SideCrossOrder> chunk(size_t i, size_t k) const { return OrderSlice<SideCrossOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<SideCrossOrder>> split(size_t k) const { return split_order(*this, k); }
 };
 
 //
@@ -252,23 +936,32 @@ public:
 //
 template<typename T>
 class MyContainer<T>::ReverseOrder {
-    const MyContainer& cont;   // Reference to container
+    std::shared_ptr<const std::vector<T>> data;  // Pinned snapshot of the container's storage
     size_t pos = 0;            // Logical position from end
 
 public:
-    ReverseOrder(const MyContainer& c) : cont(c), pos(0) {}
+    ReverseOrder(const MyContainer& c) : data(c.data), pos(0) {
+        c.mark_shared();
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Reverse);
+        c.stat_order(OrderKind::Reverse, 0, sizeof(T));
+    }
 
     const T& operator*() const {
-        const auto& data = cont.get_data();
-        if (pos >= data.size()) throw std::out_of_range("ReverseOrder dereference out of bounds");
-        return data[data.size() - 1 - pos];  // Access in reverse
+        if (pos >= data->size()) throw std::out_of_range("ReverseOrder dereference out of bounds");
+        return (*data)[data->size() - 1 - pos];  // Access in reverse
     }
 
     ReverseOrder& operator++() { ++pos; return *this; }
     bool operator==(const ReverseOrder& other) const { return pos == other.pos; }
     bool operator!=(const ReverseOrder& other) const { return !(*this == other); }
     ReverseOrder begin() const { return *this; }
-    ReverseOrder end() const { ReverseOrder it = *this; it.pos = cont.get_data().size(); return it; }
+    ReverseOrder end() const { ReverseOrder it = *this; it.pos = data->size(); return it; }
+    size_t size() const { return data->size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return (*data)[data->size() - 1 - i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<ReverseOrder> chunk(size_t i, size_t k) const { return OrderSlice<ReverseOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<ReverseOrder>> split(size_t k) const { return split_order(*this, k); }
 };
 
 //
@@ -276,23 +969,32 @@ public:
 //
 template<typename T>
 class MyContainer<T>::Order {
-    const MyContainer& cont;   // Reference to container
+    std::shared_ptr<const std::vector<T>> data;  // Pinned snapshot of the container's storage
     size_t pos = 0;            // Index from beginning
 
 public:
-    Order(const MyContainer& c) : cont(c), pos(0) {}
+    Order(const MyContainer& c) : data(c.data), pos(0) {
+        c.mark_shared();
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Order);
+        c.stat_order(OrderKind::Order, 0, sizeof(T));
+    }
 
     const T& operator*() const {
-        const auto& data = cont.get_data();
-        if (pos >= data.size()) throw std::out_of_range("Order dereference out of bounds");
-        return data[pos];  // Return element by insertion order
+        if (pos >= data->size()) throw std::out_of_range("Order dereference out of bounds");
+        return (*data)[pos];  // Return element by insertion order
     }
 
     Order& operator++() { ++pos; return *this; }
     bool operator==(const Order& other) const { return pos == other.pos; }
     bool operator!=(const Order& other) const { return !(*this == other); }
     Order begin() const { return *this; }
-    Order end() const { Order it = *this; it.pos = cont.get_data().size(); return it; }
+    Order end() const { Order it = *this; it.pos = data->size(); return it; }
+    size_t size() const { return data->size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return (*data)[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<Order> chunk(size_t i, size_t k) const { return OrderSlice<Order>(*this, i, k, size()); }
+    std::vector<OrderSlice<Order>> split(size_t k) const { return split_order(*this, k); }
 };
 
 //
@@ -301,39 +1003,161 @@ public:
 template<typename T>
 class MyContainer<T>::MiddleOutOrder {
     const MyContainer& cont;
-    std::vector<T> order;      // Elements arranged from middle outward
+    std::shared_ptr<const detail::arranged_values<T>> order;  // Elements arranged from middle outward
     size_t pos = 0;
 
 public:
     MiddleOutOrder(const MyContainer& c) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::MiddleOut);
         const auto& data = c.get_data();
-        if (data.empty()) return;
-
-        size_t mid = data.size() / 2;
-        order.push_back(data[mid]);  // Start from middle
-
-        int left = static_cast<int>(mid) - 1;
-        int right = static_cast<int>(mid) + 1;
-
-        // Alternate outward: left, right, left, right...
-        while (left >= 0 || right < static_cast<int>(data.size())) {
-            if (left >= 0) order.push_back(data[left--]);
-            if (right < static_cast<int>(data.size())) order.push_back(data[right++]);
-        }
+        c.stat_order(OrderKind::MiddleOut, data.size(), sizeof(T));
+        // Middle first, then alternate outward: left, right, left, right...
+        const size_t mid = data.size() / 2;
+        std::vector<T> arranged = detail::gather(data, [mid](size_t j) {
+            const size_t step = (j + 1) / 2;
+            return j % 2 == 1 ? mid - step : mid + step;
+        });
+        order = detail::share_arranged(std::move(arranged), c.iterator_scratch());
     }
 
     const T& operator*() const {
-        if (pos >= order.size()) throw std::out_of_range("MiddleOutOrder dereference out of bounds");
-        return order[pos];
+        if (pos >= order->values.size()) throw std::out_of_range("MiddleOutOrder dereference out of bounds");
+        return order->values[pos];
     }
 
     MiddleOutOrder& operator++() { ++pos; return *this; }
     bool operator==(const MiddleOutOrder& other) const { return pos == other.pos; }
     bool operator!=(const MiddleOutOrder& other) const { return !(*this == other); }
     MiddleOutOrder begin() const { return *this; }
-    MiddleOutOrder end() const { MiddleOutOrder it = *this; it.pos = order.size(); return it; }
+    MiddleOutOrder end() const { MiddleOutOrder it = *this; it.pos = order->values.size(); return it; }
+    size_t size() const { return order->values.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return order->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<MiddleOutOrder> chunk(size_t i, size_t k) const { return OrderSlice<MiddleOutOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<MiddleOutOrder>> split(size_t k) const { return split_order(*this, k); }
+};
+
+//
+// GroupedAscendingOrder iterator - yields (value, count) pairs for each distinct value, ascending
+//
+template<typename T>
+class MyContainer<T>::GroupedAscendingOrder {
+    const MyContainer& cont;
+    std::shared_ptr<const detail::arranged_values<std::pair<T, size_t>>> groups;  // Distinct values with their multiplicity
+    size_t pos = 0;
+
+public:
+    GroupedAscendingOrder(const MyContainer& c) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::GroupedAscending);
+        std::vector<std::pair<T, size_t>> grouped;
+        {
+            [[maybe_unused]] auto timer = c.sort_scope();
+            grouped = detail::group_ascending(c.get_data());
+        }
+        c.stat_order(OrderKind::GroupedAscending, grouped.size(), sizeof(std::pair<T, size_t>));
+        groups = detail::share_arranged(std::move(grouped), c.iterator_scratch());
+    }
+
+    const std::pair<T, size_t>& operator*() const {
+        if (pos >= groups->values.size()) throw std::out_of_range("GroupedAscendingOrder dereference out of bounds");
+        return groups->values[pos];
+    }
+
+    GroupedAscendingOrder& operator++() { ++pos; return *this; }
+    bool operator==(const GroupedAscendingOrder& other) const { return pos == other.pos; }
+    bool operator!=(const GroupedAscendingOrder& other) const { return !(*this == other); }
+    GroupedAscendingOrder begin() const { return *this; }
+    GroupedAscendingOrder end() const { GroupedAscendingOrder it = *this; it.pos = groups->values.size(); return it; }
+    size_t size() const { return groups->values.size(); }  // Elements in the whole order
+    const std::pair<T, size_t>& operator[](size_t i) const { return groups->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<GroupedAscendingOrder> chunk(size_t i, size_t k) const { return OrderSlice<GroupedAscendingOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<GroupedAscendingOrder>> split(size_t k) const { return split_order(*this, k); }
+};
+
+//
+// DistinctOrder iterator - yields each distinct value once, in ascending order
+//
+template<typename T>
+class MyContainer<T>::DistinctOrder {
+    const MyContainer& cont;
+    std::shared_ptr<const detail::arranged_values<T>> unique;  // Distinct values, sorted ascending
+    size_t pos = 0;
+
+public:
+    DistinctOrder(const MyContainer& c) : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Distinct);
+        std::vector<std::pair<T, size_t>> groups;
+        {
+            [[maybe_unused]] auto timer = c.sort_scope();
+            groups = detail::group_ascending(c.get_data());
+        }
+        c.stat_order(OrderKind::Distinct, groups.size(), sizeof(T));
+        std::vector<T> values;
+        values.reserve(groups.size());
+        for (auto& g : groups) values.push_back(std::move(g.first));
+        unique = detail::share_arranged(std::move(values), c.iterator_scratch());
+    }
+
+    const T& operator*() const {
+        if (pos >= unique->values.size()) throw std::out_of_range("DistinctOrder dereference out of bounds");
+        return unique->values[pos];
+    }
+
+    DistinctOrder& operator++() { ++pos; return *this; }
+    bool operator==(const DistinctOrder& other) const { return pos == other.pos; }
+    bool operator!=(const DistinctOrder& other) const { return !(*this == other); }
+    DistinctOrder begin() const { return *this; }
+    DistinctOrder end() const { DistinctOrder it = *this; it.pos = unique->values.size(); return it; }
+    size_t size() const { return unique->values.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return unique->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<DistinctOrder> chunk(size_t i, size_t k) const { return OrderSlice<DistinctOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<DistinctOrder>> split(size_t k) const { return split_order(*this, k); }
 };
+//
+// FrequencyOrder iterator - yields (value, count) pairs from most to least common,
+// optionally limited to the top_k most common values
+//
+template<typename T>
+class MyContainer<T>::FrequencyOrder {
+    const MyContainer& cont;
+    std::shared_ptr<const detail::arranged_values<std::pair<T, size_t>>> groups;  // Most common values first
+    size_t pos = 0;
 
+public:
+    FrequencyOrder(const MyContainer& c, size_t top_k = std::numeric_limits<size_t>::max())
+        : cont(c) {
+        [[maybe_unused]] auto scope = c.op_scope(LatencyOp::Frequency);
+        std::vector<std::pair<T, size_t>> ranked;
+        {
+            [[maybe_unused]] auto timer = c.sort_scope();
+            ranked = detail::group_by_frequency(c.get_data(), top_k);
+        }
+        c.stat_order(OrderKind::Frequency, ranked.size(), sizeof(std::pair<T, size_t>));
+        groups = detail::share_arranged(std::move(ranked), c.iterator_scratch());
+    }
+
+    const std::pair<T, size_t>& operator*() const {
+        if (pos >= groups->values.size()) throw std::out_of_range("FrequencyOrder dereference out of bounds");
+        return groups->values[pos];
+    }
+
+    FrequencyOrder& operator++() { ++pos; return *this; }
+    bool operator==(const FrequencyOrder& other) const { return pos == other.pos; }
+    bool operator!=(const FrequencyOrder& other) const { return !(*this == other); }
+    FrequencyOrder begin() const { return *this; }
+    FrequencyOrder end() const { FrequencyOrder it = *this; it.pos = groups->values.size(); return it; }
+    size_t size() const { return groups->values.size(); }  // Elements in the whole order
+    const std::pair<T, size_t>& operator[](size_t i) const { return groups->values[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<FrequencyOrder> chunk(size_t i, size_t k) const { return OrderSlice<FrequencyOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<FrequencyOrder>> split(size_t k) const { return split_order(*this, k); }
+};
 
 
 // ========================== ITERATOR ACCESSORS ==========================
@@ -373,4 +1197,37 @@ typename MyContainer<T>::MiddleOutOrder MyContainer<T>::middle_out_order() const
     return MiddleOutOrder(*this);
 }
 
+template<typename T>
+typename MyContainer<T>::GroupedAscendingOrder MyContainer<T>::grouped_ascending_order() const {
+    return GroupedAscendingOrder(*this);
+}
+
+template<typename T>
+typename MyContainer<T>::DistinctOrder MyContainer<T>::distinct_order() const {
+    return DistinctOrder(*this);
+}
+
+template<typename T>
+typename MyContainer<T>::FrequencyOrder MyContainer<T>::frequency_order(size_t top_k) const {
+    return FrequencyOrder(*this, top_k);
+}
+
+template<typename T>
+template<typename Compare>
+typename MyContainer<T>::AscendingOrder MyContainer<T>::ascending_order(Compare comp) const {
+    return AscendingOrder(*this, comp);
+}
+
+template<typename T>
+template<typename Compare>
+typename MyContainer<T>::DescendingOrder MyContainer<T>::descending_order(Compare comp) const {
+    return DescendingOrder(*this, comp);
+}
+
+template<typename T>
+template<typename Compare>
+typename MyContainer<T>::SideCrossOrder MyContainer<T>::sidecross_order(Compare comp) const {
+    return SideCrossOrder(*this, comp);
+}
+
 } // namespace myns
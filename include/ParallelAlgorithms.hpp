@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+// Parallel algorithms over an order.
+//
+// They accept any order with size() and operator[] by position: every
+// MyContainer order and ShardedContainer's sorted orders. The positions are split
+// into ranges on a work-stealing ThreadPool, so threads that finish early take
+// over part of the remaining ranges. Build the order first; the algorithms
+// only read it.
+//
+//   auto asc = c.ascending_order();
+//   myns::parallel_for_each(asc, [](const int& x) { heavy(x); });
+//   long sum = myns::parallel_transform_reduce(asc, 0L, std::plus<>(), [](int x) { return long(x) * x; });
+
+namespace myns {
+
+namespace detail {
+
+// Range size that gives each thread about 16 ranges to balance with
+inline size_t default_grain(size_t n, const ThreadPool& pool) {
+    return std::max<size_t>(1, n / (16 * (pool.size() + 1)));
+}
+
+} // namespace detail
+
+// Calls fn(element) for every element of the order, in no particular order
+// across threads; grain 0 picks a range size from the pool size
+template<typename Order, typename F>
+void parallel_for_each(const Order& order, F fn, size_t grain = 0, ThreadPool& pool = ThreadPool::shared()) {
+    const size_t n = order.size();
+    if (grain == 0) grain = detail::default_grain(n, pool);
+    pool.parallel_for(n, grain, [&order, &fn](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) fn(order[i]);
+    });
+}
+
+// Returns init combined with transform(element) for every element, in the
+// order's sequence: reduce(...reduce(reduce(init, t0), t1)..., tn-1). Each
+// range is reduced left to right, and the range results are combined in
+// position order, so reduce needs to be associative but not commutative.
+template<typename Order, typename Init, typename Reduce, typename Transform>
+Init parallel_transform_reduce(const Order& order, Init init, Reduce reduce, Transform transform,
+                               size_t grain = 0, ThreadPool& pool = ThreadPool::shared()) {
+    const size_t n = order.size();
+    if (grain == 0) grain = detail::default_grain(n, pool);
+
+    std::vector<std::pair<size_t, Init>> partials;  // (first position, range result)
+    std::mutex partials_mutex;
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end) {
+        Init acc = transform(order[begin]);
+        for (size_t i = begin + 1; i < end; ++i) acc = reduce(std::move(acc), transform(order[i]));
+        std::lock_guard<std::mutex> lock(partials_mutex);
+        partials.emplace_back(begin, std::move(acc));
+    });
+
+    std::sort(partials.begin(), partials.end(),
+              [](const std::pair<size_t, Init>& a, const std::pair<size_t, Init>& b) { return a.first < b.first; });
+    for (auto& p : partials) init = reduce(std::move(init), std::move(p.second));
+    return init;
+}
+
+} // namespace myns
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MyContainer.hpp"
+
+// PrecomputedContainer<T> - a MyContainer whose ascending view is sorted in
+// the background once writes go quiet.
+//
+// Every write marks the sorted view stale. A worker thread waits until no
+// write has arrived for the quiet period, takes a snapshot() (O(1), the
+// storage is shared copy-on-write), and sorts a copy of it off the request
+// path. Readers get the view through a std::shared_future: it is ready at once
+// when the view matches the current contents, and otherwise completes when
+// the next background sort finishes. A burst of writes therefore costs one
+// sort, paid by the worker rather than by the first reader after the burst.
+//
+// All members may be called from any thread; a mutex guards the container.
+// Under a steady stream of writes the view is only rebuilt when the writes
+// pause, so readers that cannot wait should sort a snapshot() themselves.
+
+namespace myns {
+
+template<typename T = int>
+class PrecomputedContainer {
+public:
+    using View = std::shared_ptr<const std::vector<T>>;  // Elements in ascending order, never modified
+    using Clock = std::chrono::steady_clock;
+
+    explicit PrecomputedContainer(Clock::duration quiet_period = std::chrono::milliseconds(5));
+    ~PrecomputedContainer();  // Stops the worker; futures still pending are left broken
+
+    // The worker refers to this object, so it is neither copyable nor movable
+    PrecomputedContainer(const PrecomputedContainer&) = delete;
+    PrecomputedContainer& operator=(const PrecomputedContainer&) = delete;
+
+    void add(const T& value);                  // Add element; the view goes stale
+    void remove(const T& value);               // Remove all occurrences (throws if not found)
+    size_t size() const;
+    MyContainer<T> snapshot() const;           // Current contents, for the other orders
+
+    std::shared_future<View> sorted_view() const;  // Ascending view of the current contents
+    View ascending() const;                    // sorted_view().get(): waits for a pending sort
+    bool view_ready() const;                   // True when ascending() would not wait
+    uint64_t rebuilds() const;                 // Views published so far; sorts overtaken by writes do not count
+
+private:
+    const Clock::duration quiet;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    MyContainer<T> data;
+    uint64_t version = 0;                      // Bumped by every write
+    uint64_t built = 0;                        // Version the last background sort started from
+    uint64_t rebuild_count = 0;
+    Clock::time_point last_write;
+    bool stale = false;                        // view is a promise the worker still has to keep
+    std::promise<View> pending;
+    std::shared_future<View> view;
+    bool stopping = false;
+    std::thread worker;                        // Started last, once the members above exist
+
+    void wrote();                              // Caller holds mutex
+    void run_worker();
+};
+
+
+// Implementation
+
+template<typename T>
+PrecomputedContainer<T>::PrecomputedContainer(Clock::duration quiet_period) : quiet(quiet_period) {
+    std::promise<View> empty;
+    empty.set_value(std::make_shared<const std::vector<T>>());
+    view = empty.get_future().share();
+    worker = std::thread([this] { run_worker(); });
+}
+
+template<typename T>
+PrecomputedContainer<T>::~PrecomputedContainer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+// Readers that ask from now on wait for the next sort
+template<typename T>
+void PrecomputedContainer<T>::wrote() {
+    ++version;
+    last_write = Clock::now();
+    if (!stale) {
+        pending = std::promise<View>();
+        view = pending.get_future().share();
+        stale = true;
+    }
+    changed.notify_all();
+}
+
+template<typename T>
+void PrecomputedContainer<T>::add(const T& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    data.add(value);
+    wrote();
+}
+
+// A miss throws before anything changes, so the view stays valid
+template<typename T>
+void PrecomputedContainer<T>::remove(const T& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    data.remove(value);
+    wrote();
+}
+
+template<typename T>
+size_t PrecomputedContainer<T>::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return data.size();
+}
+
+template<typename T>
+MyContainer<T> PrecomputedContainer<T>::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return data.snapshot();
+}
+
+template<typename T>
+std::shared_future<typename PrecomputedContainer<T>::View> PrecomputedContainer<T>::sorted_view() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return view;
+}
+
+template<typename T>
+typename PrecomputedContainer<T>::View PrecomputedContainer<T>::ascending() const {
+    return sorted_view().get();
+}
+
+template<typename T>
+bool PrecomputedContainer<T>::view_ready() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !stale;
+}
+
+template<typename T>
+uint64_t PrecomputedContainer<T>::rebuilds() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rebuild_count;
+}
+
+// Waits for a write, then for the quiet period after the last one, and sorts
+// a snapshot without holding the lock. A sort overtaken by newer writes is
+// dropped and the promise is kept for the next one.
+template<typename T>
+void PrecomputedContainer<T>::run_worker() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [this] { return stopping || built != version; });
+        while (!stopping && Clock::now() - last_write < quiet) changed.wait_until(lock, last_write + quiet);
+        if (stopping) return;
+
+        const uint64_t v = version;
+        built = v;
+        MyContainer<T> snap = data.snapshot();
+        lock.unlock();
+
+        View sorted;
+        std::exception_ptr error;
+        try {
+            auto values = std::make_shared<std::vector<T>>(detail::copy_of(snap.get_data()));
+            detail::sort_ascending(*values);
+            sorted = std::move(values);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if (version != v) continue;  // Stale before it was finished
+        ++rebuild_count;
+        if (error) pending.set_exception(error);
+        else pending.set_value(std::move(sorted));
+        stale = false;
+    }
+}
+
+} // namespace myns
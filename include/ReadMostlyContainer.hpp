@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Epoch.hpp"
+#include "MyContainer.hpp"
+
+// ReadMostlyContainer<T> - a MyContainer for many readers and rare writers.
+//
+// Readers never lock and never write a cache line another thread writes: they
+// enter an epoch::Guard, load the published version and read it in place.
+// snapshot() is the exception, see there.
+// Writers serialize on a mutex, copy the current version, change the copy,
+// publish it with one atomic exchange, and retire the old version. Retired
+// versions are freed once every reader that could still see them has left
+// its guard (epoch-based reclamation).
+//
+// Each write copies the elements, so batch several changes with update().
+
+namespace myns {
+
+template<typename T = int>
+class ReadMostlyContainer {
+public:
+    ReadMostlyContainer();
+    ~ReadMostlyContainer();
+
+    // Readers hold raw pointers to versions, so it is neither copyable nor movable
+    ReadMostlyContainer(const ReadMostlyContainer&) = delete;
+    ReadMostlyContainer& operator=(const ReadMostlyContainer&) = delete;
+
+    // Writers (serialized; each call publishes one new version)
+    void add(const T& value);                  // Add element
+    void remove(const T& value);               // Remove all occurrences (throws if not found)
+    template<typename F> void update(F f);     // Apply f(MyContainer<T>&) to a copy, then publish it
+
+    // Readers (lock-free)
+    size_t size() const;                       // Number of elements in the current version
+    bool contains(const T& value) const;       // Linear search of the current version
+    T at(size_t index) const;                  // Copy of an element; throws std::out_of_range
+    template<typename F> auto read(F f) const; // Calls f(const std::vector<T>&) on the current version
+    MyContainer<T> private_copy() const;       // O(n) copy of the current version, for running orders
+
+    // O(1), but writes the reference count every snapshot() caller shares; see below
+    MyContainer<T> snapshot() const;
+
+    size_t retired_versions() const;           // Old versions still waiting for readers to leave
+    void collect();                            // Free retired versions no reader can still see
+
+private:
+    struct Retired {
+        const MyContainer<T>* version;
+        uint64_t epoch;  // Epoch in which it was unlinked
+    };
+
+    std::atomic<const MyContainer<T>*> current;
+    mutable std::mutex write_mutex;  // Serializes writers and guards retired
+    std::vector<Retired> retired;
+
+    void publish(std::unique_ptr<const MyContainer<T>> next);
+    void reclaim();
+};
+
+
+// Implementation
+
+template<typename T>
+ReadMostlyContainer<T>::ReadMostlyContainer() : current(new MyContainer<T>()) {}
+
+// Frees every version; no reader or writer may be running
+template<typename T>
+ReadMostlyContainer<T>::~ReadMostlyContainer() {
+    delete current.load(std::memory_order_relaxed);
+    for (const Retired& r : retired) delete r.version;
+}
+
+// Swaps in a new version and retires the old one. Readers announce their
+// epoch before loading current, so a reader that still sees the old version
+// announced an epoch no later than the one it is retired with. The retired
+// list grows first, so running out of memory publishes nothing and leaks nothing.
+template<typename T>
+void ReadMostlyContainer<T>::publish(std::unique_ptr<const MyContainer<T>> next) {
+    retired.reserve(retired.size() + 1);
+    const MyContainer<T>* old = current.exchange(next.release(), std::memory_order_seq_cst);
+    retired.push_back({old, epoch::advance()});
+    reclaim();
+}
+
+// Frees retired versions that no active reader can still hold
+template<typename T>
+void ReadMostlyContainer<T>::reclaim() {
+    const uint64_t oldest = epoch::oldest_active();
+    auto done = std::partition(retired.begin(), retired.end(), [oldest](const Retired& r) {
+        return r.epoch >= oldest;  // Still visible to a reader that entered by r.epoch
+    });
+    for (auto it = done; it != retired.end(); ++it) delete it->version;
+    retired.erase(done, retired.end());
+}
+
+template<typename T>
+template<typename F>
+void ReadMostlyContainer<T>::update(F f) {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    const MyContainer<T>* cur = current.load(std::memory_order_relaxed);
+    auto next = std::make_unique<MyContainer<T>>(cur->get_data());  // Private copy of the elements
+    f(*next);
+    publish(std::move(next));
+}
+
+template<typename T>
+void ReadMostlyContainer<T>::add(const T& value) {
+    update([&value](MyContainer<T>& c) { c.add(value); });
+}
+
+// Throws before publishing anything if the value is not present
+template<typename T>
+void ReadMostlyContainer<T>::remove(const T& value) {
+    update([&value](MyContainer<T>& c) { c.remove(value); });
+}
+
+template<typename T>
+template<typename F>
+auto ReadMostlyContainer<T>::read(F f) const {
+    epoch::Guard guard;
+    return f(current.load(std::memory_order_acquire)->get_data());
+}
+
+template<typename T>
+size_t ReadMostlyContainer<T>::size() const {
+    return read([](const std::vector<T>& v) { return v.size(); });
+}
+
+template<typename T>
+bool ReadMostlyContainer<T>::contains(const T& value) const {
+    return read([&value](const std::vector<T>& v) { return std::find(v.begin(), v.end(), value) != v.end(); });
+}
+
+template<typename T>
+T ReadMostlyContainer<T>::at(size_t index) const {
+    return read([index](const std::vector<T>& v) { return v.at(index); });
+}
+
+// Copies the elements into storage of the caller's own. It reads the current
+// version in place under the guard, so like read() it writes nothing another
+// reader touches, and orders built on the copy stay thread-private too.
+template<typename T>
+MyContainer<T> ReadMostlyContainer<T>::private_copy() const {
+    return read([](const std::vector<T>& v) { return MyContainer<T>(v); });
+}
+
+// Shares the current version's storage (copy-on-write), so it stays valid
+// after the version is reclaimed. Sharing increments the storage's reference
+// count and sets the version's shared flag, both on lines every snapshot()
+// caller writes, so concurrent snapshot() calls contend with each other. Use
+// read() or private_copy() on hot read paths.
+template<typename T>
+MyContainer<T> ReadMostlyContainer<T>::snapshot() const {
+    epoch::Guard guard;
+    return current.load(std::memory_order_acquire)->snapshot();
+}
+
+// Writes reclaim on their own; this frees versions whose readers left after the last write
+template<typename T>
+void ReadMostlyContainer<T>::collect() {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    reclaim();
+}
+
+template<typename T>
+size_t ReadMostlyContainer<T>::retired_versions() const {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    return retired.size();
+}
+
+} // namespace myns
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "MyContainer.hpp"
+#include "ThreadPool.hpp"
+
+// ShardedContainer<T> - a MyContainer split into shards so writes scale across cores.
+//
+// Each shard is a vector with its own mutex, padded to a cache line. add()
+// goes to the calling thread's shard (picked by hashing its thread id), so
+// threads on different shards never contend. remove() and the readers lock
+// every shard in index order, so they see one consistent state.
+//
+// The sorted orders copy each shard under the locks, sort the copies in
+// parallel on ThreadPool::shared() and k-way merge the sorted runs. The other
+// orders run over snapshot(), a MyContainer<T> holding every element.
+// Elements from different shards come out in shard order, not insertion order.
+
+namespace myns {
+
+template<typename T = int>
+class ShardedContainer {
+public:
+    // Below this many elements the shards are sorted on the calling thread, not the pool
+    static constexpr size_t parallel_threshold = size_t(1) << 14;
+
+    class SortedOrder;
+
+    explicit ShardedContainer(size_t shard_count = std::max(1u, std::thread::hardware_concurrency()));
+
+    // Shards hold mutexes, so it is neither copyable nor movable
+    ShardedContainer(const ShardedContainer&) = delete;
+    ShardedContainer& operator=(const ShardedContainer&) = delete;
+
+    void add(const T& value);                  // Add to the calling thread's shard
+    void remove(const T& value);               // Remove all occurrences (throws if not found)
+    size_t size() const;                       // Number of elements in all shards
+    bool contains(const T& value) const;
+    size_t shard_count() const;
+
+    MyContainer<T> snapshot() const;           // Every element, shard by shard
+
+    // Orders merged from per-shard sorted runs
+    SortedOrder ascending_order() const;
+    SortedOrder descending_order() const;
+    SortedOrder sidecross_order() const;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::vector<T> values;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard& local_shard();
+    std::vector<std::unique_lock<std::mutex>> lock_all() const;
+    std::vector<T> merged() const;             // Every element, ascending
+};
+
+//
+// SortedOrder - walks a merged arrangement of the shards' elements
+//
+template<typename T>
+class ShardedContainer<T>::SortedOrder {
+    std::vector<T> order;        // Elements in iteration order
+    size_t pos = 0;
+
+public:
+    explicit SortedOrder(std::vector<T> arranged) : order(std::move(arranged)) {}
+
+    const T& operator*() const {
+        if (pos >= order.size()) throw std::out_of_range("SortedOrder dereference out of bounds");
+        return order[pos];
+    }
+
+    SortedOrder& operator++() { ++pos; return *this; }
+    bool operator==(const SortedOrder& other) const { return pos == other.pos; }
+    bool operator!=(const SortedOrder& other) const { return !(*this == other); }
+    SortedOrder begin() const { return *this; }
+    SortedOrder end() const { SortedOrder it = *this; it.pos = order.size(); return it; }
+    size_t size() const { return order.size(); }  // Elements in the whole order
+    const T& operator[](size_t i) const { return order[i]; }  // i-th element of the order, unchecked
+
+    // Near-equal slices by position, for handing to other threads; the order must outlive them
+    OrderSlice<SortedOrder> chunk(size_t i, size_t k) const { return OrderSlice<SortedOrder>(*this, i, k, size()); }
+    std::vector<OrderSlice<SortedOrder>> split(size_t k) const { return split_order(*this, k); }
+};
+
+
+// Implementation
+
+template<typename T>
+ShardedContainer<T>::ShardedContainer(size_t shard_count) {
+    if (shard_count == 0) throw std::invalid_argument("ShardedContainer needs at least one shard");
+    shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) shards.push_back(std::make_unique<Shard>());
+}
+
+// The calling thread always lands on the same shard
+template<typename T>
+typename ShardedContainer<T>::Shard& ShardedContainer<T>::local_shard() {
+    thread_local const size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return *shards[hash % shards.size()];
+}
+
+// Locks every shard in index order; writers only ever hold one, so this cannot deadlock
+template<typename T>
+std::vector<std::unique_lock<std::mutex>> ShardedContainer<T>::lock_all() const {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shards.size());
+    for (const auto& s : shards) locks.emplace_back(s->mutex);
+    return locks;
+}
+
+template<typename T>
+void ShardedContainer<T>::add(const T& value) {
+    Shard& s = local_shard();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.values.push_back(value);
+}
+
+// Removes from every shard at once, or from none if the value is missing
+template<typename T>
+void ShardedContainer<T>::remove(const T& value) {
+    auto locks = lock_all();
+    bool found = false;
+    for (auto& s : shards) {
+        auto it = std::remove(s->values.begin(), s->values.end(), value);
+        found |= it != s->values.end();
+        s->values.erase(it, s->values.end());
+    }
+    if (!found) throw std::runtime_error("Element not found");
+}
+
+template<typename T>
+size_t ShardedContainer<T>::size() const {
+    auto locks = lock_all();
+    size_t n = 0;
+    for (const auto& s : shards) n += s->values.size();
+    return n;
+}
+
+template<typename T>
+bool ShardedContainer<T>::contains(const T& value) const {
+    auto locks = lock_all();
+    for (const auto& s : shards) {
+        if (std::find(s->values.begin(), s->values.end(), value) != s->values.end()) return true;
+    }
+    return false;
+}
+
+template<typename T>
+size_t ShardedContainer<T>::shard_count() const {
+    return shards.size();
+}
+
+template<typename T>
+MyContainer<T> ShardedContainer<T>::snapshot() const {
+    auto locks = lock_all();
+    std::vector<T> values;
+    size_t n = 0;
+    for (const auto& s : shards) n += s->values.size();
+    values.reserve(n);
+    for (const auto& s : shards) values.insert(values.end(), s->values.begin(), s->values.end());
+    return MyContainer<T>(std::move(values));
+}
+
+// Copies the shards under their locks, sorts the copies on the shared pool
+// (one run per task), then merges the runs through a min-heap of run heads
+template<typename T>
+std::vector<T> ShardedContainer<T>::merged() const {
+    std::vector<std::vector<T>> runs;
+    size_t n = 0;
+    {
+        auto locks = lock_all();
+        runs.reserve(shards.size());
+        for (const auto& s : shards) {
+            if (s->values.empty()) continue;
+            runs.push_back(s->values);
+            n += s->values.size();
+        }
+    }
+
+    if (runs.size() > 1 && n >= parallel_threshold) {
+        ThreadPool::shared().parallel_for(runs.size(), 1, [&runs](size_t begin, size_t end) {
+            for (size_t r = begin; r < end; ++r) detail::sort_ascending(runs[r]);
+        });
+    } else {
+        for (auto& run : runs) detail::sort_ascending(run);
+    }
+
+    if (runs.empty()) return {};
+    if (runs.size() == 1) return std::move(runs[0]);
+
+    // heap holds (run, position) cursors; the smallest head sits on top
+    using Cursor = std::pair<size_t, size_t>;
+    auto greater = [&runs](const Cursor& a, const Cursor& b) {
+        const T& x = runs[a.first][a.second];
+        const T& y = runs[b.first][b.second];
+        if (y < x) return true;
+        return !(x < y) && a.first > b.first;  // Ties leave in shard order
+    };
+    std::vector<Cursor> heap;
+    heap.reserve(runs.size());
+    for (size_t r = 0; r < runs.size(); ++r) heap.push_back({r, 0});
+    std::make_heap(heap.begin(), heap.end(), greater);
+
+    std::vector<T> out;
+    out.reserve(n);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Cursor& c = heap.back();
+        out.push_back(std::move(runs[c.first][c.second]));
+        if (++c.second < runs[c.first].size()) std::push_heap(heap.begin(), heap.end(), greater);
+        else heap.pop_back();
+    }
+    return out;
+}
+
+template<typename T>
+typename ShardedContainer<T>::SortedOrder ShardedContainer<T>::ascending_order() const {
+    return SortedOrder(merged());
+}
+
+template<typename T>
+typename ShardedContainer<T>::SortedOrder ShardedContainer<T>::descending_order() const {
+    std::vector<T> sorted = merged();
+    detail::reverse(sorted);  // Mirrored chunks on the pool once large enough
+    return SortedOrder(std::move(sorted));
+}
+
+// Smallest, largest, next smallest, next largest, ...
+template<typename T>
+typename ShardedContainer<T>::SortedOrder ShardedContainer<T>::sidecross_order() const {
+    std::vector<T> sorted = merged();
+    std::vector<T> order;
+    order.reserve(sorted.size());
+    for (size_t left = 0, right = sorted.size(); left < right;) {
+        order.push_back(std::move(sorted[left++]));
+        if (left < right) order.push_back(std::move(sorted[--right]));
+    }
+    return SortedOrder(std::move(order));
+}
+
+} // namespace myns
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MyContainer.hpp"
+
+// SideCrossQueue<T> - a double-ended priority queue for side-cross consumption.
+//
+// Elements live in a min-max heap: a binary heap in one vector whose even
+// levels (root = level 0) are ordered like a min-heap and odd levels like a
+// max-heap. The smallest element is the root and the largest is one of its
+// two children, so both ends are read in O(1) and removed in O(log n), and
+// push() is O(log n). Unlike SideCrossOrder, nothing has to be re-sorted when
+// elements keep arriving.
+//
+// pop_sidecross() alternates pop_min() and pop_max(), starting with the
+// minimum, so draining a queue built from a container yields the same
+// sequence as its sidecross_order(). Only T's operator< is used.
+
+namespace myns {
+
+template<typename T = int>
+class SideCrossQueue {
+public:
+    SideCrossQueue() = default;
+    explicit SideCrossQueue(const MyContainer<T>& c);  // Heapifies a copy of the elements in O(n)
+
+    void push(const T& value);                 // O(log n)
+    const T& min() const;                      // Smallest element; throws std::out_of_range if empty
+    const T& max() const;                      // Largest element; throws std::out_of_range if empty
+    T pop_min();                               // Remove and return the smallest element, O(log n)
+    T pop_max();                               // Remove and return the largest element, O(log n)
+    T pop_sidecross();                         // pop_min(), then pop_max(), then pop_min(), ...
+
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t capacity);             // Room for pushes that then do not allocate
+
+private:
+    std::vector<T> heap;
+    bool max_next = false;  // pop_sidecross() takes the maximum next
+
+    // Level parity of an index: even levels are min levels
+    static bool on_min_level(size_t i) {
+        size_t level = 0;
+        for (size_t n = i + 1; n > 1; n >>= 1) ++level;
+        return level % 2 == 0;
+    }
+
+    // a comes first on a min level (Max = false) or a max level (Max = true)
+    template<bool Max>
+    static bool before(const T& a, const T& b) { return Max ? b < a : a < b; }
+
+    size_t max_index() const;
+    void check_not_empty() const;
+
+    template<bool Max> void bubble_up(size_t i);
+    template<bool Max> void trickle_down(size_t i);
+    void sift_up(size_t i);
+    void sift_down(size_t i);
+    T take(size_t i);                          // Remove heap[i] and restore the heap
+};
+
+
+// Implementation
+
+// Floyd's bottom-up construction: trickle every internal node down, last first
+template<typename T>
+SideCrossQueue<T>::SideCrossQueue(const MyContainer<T>& c) : heap(c.get_data()) {
+    for (size_t i = heap.size() / 2; i-- > 0;) sift_down(i);
+}
+
+// Moves heap[i] up through grandparents on its own kind of level
+template<typename T>
+template<bool Max>
+void SideCrossQueue<T>::bubble_up(size_t i) {
+    while (i >= 3) {
+        const size_t grandparent = (i - 3) / 4;
+        if (!before<Max>(heap[i], heap[grandparent])) break;
+        std::swap(heap[i], heap[grandparent]);
+        i = grandparent;
+    }
+}
+
+// A new element first settles against its parent, which sits on the other kind of level
+template<typename T>
+void SideCrossQueue<T>::sift_up(size_t i) {
+    if (i == 0) return;
+    const size_t parent = (i - 1) / 2;
+    if (on_min_level(i)) {
+        if (heap[parent] < heap[i]) {
+            std::swap(heap[i], heap[parent]);
+            bubble_up<true>(parent);
+        } else {
+            bubble_up<false>(i);
+        }
+    } else {
+        if (heap[i] < heap[parent]) {
+            std::swap(heap[i], heap[parent]);
+            bubble_up<false>(parent);
+        } else {
+            bubble_up<true>(i);
+        }
+    }
+}
+
+// Moves heap[i] down to the first of its children and grandchildren; after
+// a swap with a grandchild it also settles against the parent in between
+template<typename T>
+template<bool Max>
+void SideCrossQueue<T>::trickle_down(size_t i) {
+    const size_t n = heap.size();
+    while (2 * i + 1 < n) {
+        size_t m = 2 * i + 1;
+        const size_t candidates[] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+        for (size_t c : candidates) {
+            if (c < n && before<Max>(heap[c], heap[m])) m = c;
+        }
+        if (!before<Max>(heap[m], heap[i])) return;
+        std::swap(heap[m], heap[i]);
+        if (m <= 2 * i + 2) return;  // A child has no descendants on i's kind of level below it
+
+        const size_t parent = (m - 1) / 2;
+        if (before<Max>(heap[parent], heap[m])) std::swap(heap[m], heap[parent]);
+        i = m;
+    }
+}
+
+template<typename T>
+void SideCrossQueue<T>::sift_down(size_t i) {
+    if (on_min_level(i)) trickle_down<false>(i);
+    else trickle_down<true>(i);
+}
+
+template<typename T>
+void SideCrossQueue<T>::push(const T& value) {
+    heap.push_back(value);
+    sift_up(heap.size() - 1);
+}
+
+// The maximum is the root when alone, else the larger child of the root
+template<typename T>
+size_t SideCrossQueue<T>::max_index() const {
+    if (heap.size() < 3) return heap.size() - 1;
+    return heap[1] < heap[2] ? 2 : 1;
+}
+
+template<typename T>
+void SideCrossQueue<T>::check_not_empty() const {
+    if (heap.empty()) throw std::out_of_range("SideCrossQueue is empty");
+}
+
+template<typename T>
+const T& SideCrossQueue<T>::min() const {
+    check_not_empty();
+    return heap[0];
+}
+
+template<typename T>
+const T& SideCrossQueue<T>::max() const {
+    check_not_empty();
+    return heap[max_index()];
+}
+
+// Fills the hole with the last element and trickles it down from there
+template<typename T>
+T SideCrossQueue<T>::take(size_t i) {
+    T value = std::move(heap[i]);
+    if (i + 1 < heap.size()) {
+        heap[i] = std::move(heap.back());
+        heap.pop_back();
+        sift_down(i);
+    } else {
+        heap.pop_back();
+    }
+    return value;
+}
+
+template<typename T>
+T SideCrossQueue<T>::pop_min() {
+    check_not_empty();
+    return take(0);
+}
+
+template<typename T>
+T SideCrossQueue<T>::pop_max() {
+    check_not_empty();
+    return take(max_index());
+}
+
+template<typename T>
+T SideCrossQueue<T>::pop_sidecross() {
+    check_not_empty();
+    T value = max_next ? take(max_index()) : take(0);
+    max_next = !max_next;
+    return value;
+}
+
+template<typename T>
+size_t SideCrossQueue<T>::size() const {
+    return heap.size();
+}
+
+template<typename T>
+bool SideCrossQueue<T>::empty() const {
+    return heap.empty();
+}
+
+template<typename T>
+void SideCrossQueue<T>::reserve(size_t capacity) {
+    heap.reserve(capacity);
+}
+
+} // namespace myns
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compile-time choice of the sort used by the sorted orders.
+//
+// sort_traits<T>::backend names a class with a static
+// `template<typename U> void sort(std::vector<U>&)` that sorts ascending.
+// The built-in choices are:
+//  * char, signed char, unsigned char - counting_sort
+//  * other integers, float, double    - radix_sort
+//  * std::string                      - prefix_key_sort
+//  * everything else                  - comparison_sort (std::sort with operator<)
+// Specialize sort_traits for your own type to plug in another backend:
+//
+//   template<> struct myns::sort_traits<Point> { using backend = MyPointSort; };
+//
+// The backend is picked by template specialization at compile time, so there is
+// no runtime dispatch.
+
+namespace myns {
+
+// ========================== SORT BACKENDS ==========================
+
+// std::sort with operator< (introsort); works for any T the container accepts
+struct comparison_sort {
+    template<typename T>
+    static void sort(std::vector<T>& v) {
+        std::sort(v.begin(), v.end());
+    }
+};
+
+// Counting sort for one-byte integer types: one pass to count, one to rewrite
+struct counting_sort {
+    template<typename T>
+    static void sort(std::vector<T>& v) {
+        static_assert(std::is_integral<T>::value && sizeof(T) == 1, "counting_sort needs a one-byte integer type");
+        // Flipping the sign bit maps signed values to unsigned keys in the same order
+        constexpr unsigned flip = std::is_signed<T>::value ? 0x80u : 0u;
+
+        size_t counts[256] = {};
+        for (T x : v) ++counts[static_cast<unsigned char>(x) ^ flip];
+
+        size_t out = 0;
+        for (unsigned key = 0; key < 256; ++key) {
+            const T value = static_cast<T>(static_cast<unsigned char>(key ^ flip));
+            std::fill_n(v.begin() + out, counts[key], value);
+            out += counts[key];
+        }
+    }
+};
+
+// LSD radix sort on 8-bit digits for integers and floating-point numbers.
+// Digits that are equal in every element are skipped, already sorted input
+// returns after one scan, and inputs below small_input fall back to std::sort
+// to avoid the scratch buffer.
+struct radix_sort {
+    static constexpr size_t small_input = 256;
+
+    // Unsigned key whose order matches T's operator<
+    template<typename T>
+    static auto key(T x) {
+        if constexpr (std::is_floating_point<T>::value) {
+            using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            static_assert(sizeof(T) == sizeof(U), "radix_sort supports float and double");
+            U bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            const U sign = U(1) << (sizeof(U) * 8 - 1);
+            return (bits & sign) ? static_cast<U>(~bits) : static_cast<U>(bits | sign);  // Negatives reversed
+        } else {
+            using U = std::make_unsigned_t<T>;
+            constexpr U flip = std::is_signed<T>::value ? U(U(1) << (sizeof(U) * 8 - 1)) : U(0);
+            return static_cast<U>(static_cast<U>(x) ^ flip);
+        }
+    }
+
+    template<typename T>
+    static void sort(std::vector<T>& v) {
+        static_assert(std::is_arithmetic<T>::value, "radix_sort needs an integer or floating-point type");
+        if (v.size() < small_input) {
+            std::sort(v.begin(), v.end());
+            return;
+        }
+        if (std::is_sorted(v.begin(), v.end())) return;  // Stops at the first descent on unsorted input
+
+        constexpr size_t digits = sizeof(T);
+        size_t counts[digits][256] = {};
+        for (T x : v) {
+            auto k = key(x);
+            for (size_t d = 0; d < digits; ++d) ++counts[d][(k >> (8 * d)) & 0xff];
+        }
+
+        std::vector<T> buffer(v.size());
+        std::vector<T>* from = &v;
+        std::vector<T>* to = &buffer;
+        for (size_t d = 0; d < digits; ++d) {
+            size_t* count = counts[d];
+            if (std::find(count, count + 256, v.size()) != count + 256) continue;  // Digit is constant
+
+            size_t offset = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                const size_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+            for (T x : *from) (*to)[count[(key(x) >> (8 * d)) & 0xff]++] = x;
+            std::swap(from, to);
+        }
+        if (from != &v) v.swap(buffer);
+    }
+};
+
+// Sorts strings on their first 8 bytes packed into an integer key, stored
+// next to the string's index. Full comparisons only run when two keys tie.
+struct prefix_key_sort {
+    // Packs the first 8 bytes of a string into a big-endian key.
+    // Shorter strings are padded with zero bytes, so key order agrees with
+    // std::string's operator< whenever two keys differ.
+    static std::uint64_t key(const std::string& s) {
+        std::uint64_t k = 0;
+        const size_t n = std::min<size_t>(s.size(), 8);
+        for (size_t i = 0; i < 8; ++i) {
+            k <<= 8;
+            if (i < n) k |= static_cast<unsigned char>(s[i]);
+        }
+        return k;
+    }
+
+    static void sort(std::vector<std::string>& v) {
+        struct Entry {
+            std::uint64_t key;
+            size_t index;
+        };
+
+        std::vector<Entry> entries(v.size());
+        for (size_t i = 0; i < v.size(); ++i) {
+            entries[i] = {key(v[i]), i};
+        }
+
+        std::sort(entries.begin(), entries.end(), [&v](const Entry& a, const Entry& b) {
+            if (a.key != b.key) return a.key < b.key;
+            return v[a.index] < v[b.index];  // Tie on the prefix - compare in full
+        });
+
+        // Move the strings into their sorted positions
+        std::vector<std::string> result;
+        result.reserve(v.size());
+        for (const Entry& e : entries) result.push_back(std::move(v[e.index]));
+        v.swap(result);
+    }
+};
+
+// ========================== STRATEGY SELECTION ==========================
+
+// Picks the sort backend for T; specialize to register a backend for your own type
+template<typename T, typename = void>
+struct sort_traits {
+    using backend = comparison_sort;
+};
+
+template<typename T>
+struct sort_traits<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 1>> {
+    using backend = counting_sort;
+};
+
+template<typename T>
+struct sort_traits<T, std::enable_if_t<std::is_integral<T>::value && (sizeof(T) > 1)>> {
+    using backend = radix_sort;
+};
+
+template<typename T>
+struct sort_traits<T, std::enable_if_t<std::is_same<T, float>::value || std::is_same<T, double>::value>> {
+    using backend = radix_sort;
+};
+
+template<>
+struct sort_traits<std::string> {
+    using backend = prefix_key_sort;
+};
+
+// The backend sort_traits chooses for T
+template<typename T>
+using sort_backend_t = typename sort_traits<T>::backend;
+
+} // namespace myns
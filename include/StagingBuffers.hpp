@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "MyContainer.hpp"
+
+// StagingBuffers<T> - per-thread add() buffers in front of a MyContainer.
+//
+// Each thread that calls add() gets its own buffer, so appends take no lock
+// and touch no memory another thread writes. When a buffer reaches the flush
+// threshold, its thread splices it into the container under a mutex, in one
+// bulk move (MyContainer::splice). flush() splices whatever is left.
+// Elements from one thread keep their relative order; elements from different
+// threads interleave batch by batch.
+//
+// The container may only be read after flush(), while no add() is running.
+// The destructor flushes too, but cannot report a failure: if the container
+// cannot grow, whatever is still staged is dropped. Call flush() first to get
+// the exception instead.
+
+namespace myns {
+
+template<typename T = int>
+class StagingBuffers {
+public:
+    static constexpr size_t default_flush_threshold = 1024;
+
+    explicit StagingBuffers(MyContainer<T>& target, size_t flush_threshold = default_flush_threshold);
+    ~StagingBuffers();  // Flushes, dropping what is left if that throws; no add() may be running
+
+    // Threads cache a pointer to their buffer, so it is neither copyable nor movable
+    StagingBuffers(const StagingBuffers&) = delete;
+    StagingBuffers& operator=(const StagingBuffers&) = delete;
+
+    void add(const T& value);                  // Append to the calling thread's buffer
+    void flush();                              // Splice every buffer into the container; no add() may be running
+    size_t staged() const;                     // Elements not yet flushed; no add() may be running
+    size_t flush_threshold() const;
+
+private:
+    struct alignas(64) Buffer {
+        uint64_t owner;                        // thread_token() of the thread that fills it
+        std::vector<T> values;
+    };
+
+    MyContainer<T>& target;
+    const size_t threshold;
+    const uint64_t id;                         // Never reused, so a cached pointer from a dead instance never matches
+    mutable std::mutex mutex;                  // Guards target and buffers
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    Buffer& local_buffer();
+    void splice(Buffer& b);                    // Caller holds mutex
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Per-thread token, never reused (std::thread::id may be reused by a later thread)
+    static uint64_t thread_token() {
+        static std::atomic<uint64_t> counter{0};
+        thread_local const uint64_t token = counter.fetch_add(1, std::memory_order_relaxed);
+        return token;
+    }
+};
+
+
+// Implementation
+
+template<typename T>
+StagingBuffers<T>::StagingBuffers(MyContainer<T>& c, size_t flush_threshold)
+    : target(c), threshold(flush_threshold == 0 ? 1 : flush_threshold), id(next_id()) {}
+
+template<typename T>
+StagingBuffers<T>::~StagingBuffers() {
+    try {
+        flush();
+    } catch (...) {
+        // No way to report from a destructor; the elements still staged are lost
+    }
+}
+
+// The calling thread's buffer. Each thread caches only the instance it used
+// last, so instances it has finished with leave nothing behind; switching
+// instances looks the buffer up again under the lock, registering it on the
+// thread's first add().
+template<typename T>
+typename StagingBuffers<T>::Buffer& StagingBuffers<T>::local_buffer() {
+    thread_local std::pair<uint64_t, Buffer*> last{UINT64_MAX, nullptr};  // (instance id, buffer)
+    if (last.first == id) return *last.second;
+
+    const uint64_t self = thread_token();
+    std::lock_guard<std::mutex> lock(mutex);
+    Buffer* b = nullptr;
+    for (auto& candidate : buffers) {
+        if (candidate->owner == self) b = candidate.get();
+    }
+    if (!b) {
+        buffers.push_back(std::make_unique<Buffer>());
+        b = buffers.back().get();
+        b->owner = self;
+        b->values.reserve(threshold);
+    }
+    last = {id, b};
+    return *b;
+}
+
+template<typename T>
+void StagingBuffers<T>::splice(Buffer& b) {
+    if (!b.values.empty()) target.splice(b.values);
+}
+
+// Appends without synchronization; the thread that fills its buffer flushes it
+template<typename T>
+void StagingBuffers<T>::add(const T& value) {
+    Buffer& b = local_buffer();
+    b.values.push_back(value);
+    if (b.values.size() >= threshold) {
+        std::lock_guard<std::mutex> lock(mutex);
+        splice(b);
+    }
+}
+
+template<typename T>
+void StagingBuffers<T>::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& b : buffers) splice(*b);
+}
+
+template<typename T>
+size_t StagingBuffers<T>::staged() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t n = 0;
+    for (const auto& b : buffers) n += b->values.size();
+    return n;
+}
+
+template<typename T>
+size_t StagingBuffers<T>::flush_threshold() const {
+    return threshold;
+}
+
+} // namespace myns
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A small fixed-size work-stealing thread pool for splitting index ranges.
+//
+// Every worker owns a deque of tasks. A worker pushes and pops at the back of
+// its own deque (newest first, while its data is still in cache) and, when it
+// runs dry, steals from the front of the others (oldest, and so the largest
+// ranges). Threads outside the pool submit through a shared injection queue.
+//
+// parallel_for(n, chunk, f) calls f(begin, end) on disjoint ranges of at most
+// `chunk` indices that together cover [0, n). A range is split in half
+// repeatedly, each upper half becoming a task others can steal, so idle
+// threads take over large pieces of work from busy ones. The calling thread
+// runs tasks too while it waits, so a parallel_for issued from inside a task
+// finishes even when no other worker is free; with nothing left to run it
+// sleeps until its last range finishes. If a split cannot be queued (out of
+// memory), the range runs on the current thread instead. The first exception
+// thrown by f is rethrown to the caller after every range has run.
+
+namespace myns {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = default_threads());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool, started on first use
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // One worker per hardware thread besides the caller, and at least one
+    static size_t default_threads() {
+        return std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    size_t size() const { return workers.size(); }  // Worker threads, not counting callers
+
+    template<typename F>
+    void parallel_for(size_t n, size_t chunk, F&& f);
+
+private:
+    using Task = std::function<void()>;
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // One per worker, then the injection queue
+    std::atomic<size_t> queued{0};               // Tasks waiting in any queue
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;                       // Guarded by sleep_mutex
+    std::vector<std::thread> workers;
+
+    // Index of the calling thread's queue, or the injection queue for outside threads
+    size_t local_queue() const;
+
+    void push(Task task);
+    void notify_finished();                      // Wakes callers waiting for a parallel_for
+    bool run_one(size_t self);                   // Runs one task from anywhere; false if none was found
+    void run_worker(size_t self);
+};
+
+
+// Implementation
+
+namespace detail {
+
+// The pool the calling thread works for, and its queue there
+struct pool_worker {
+    const void* pool = nullptr;
+    size_t index = 0;
+};
+
+inline pool_worker& current_pool_worker() {
+    thread_local pool_worker worker;
+    return worker;
+}
+
+} // namespace detail
+
+inline ThreadPool::ThreadPool(size_t threads) {
+    for (size_t i = 0; i <= threads; ++i) queues.push_back(std::make_unique<Queue>());
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back([this, i] { run_worker(i); });
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+inline size_t ThreadPool::local_queue() const {
+    const detail::pool_worker& w = detail::current_pool_worker();
+    return w.pool == this ? w.index : workers.size();
+}
+
+inline void ThreadPool::push(Task task) {
+    Queue& q = *queues[local_queue()];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }  // A worker between its check and its wait sees the count
+    wake.notify_one();
+}
+
+inline void ThreadPool::notify_finished() {
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }  // Same handshake as push()
+    wake.notify_all();
+}
+
+// Own queue from the back, then the injection queue and the other workers from the front
+inline bool ThreadPool::run_one(size_t self) {
+    Task task;
+    for (size_t k = 0; k < queues.size() && !task; ++k) {
+        const size_t victim = (self + k) % queues.size();
+        Queue& q = *queues[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        if (victim == self) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        } else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+inline void ThreadPool::run_worker(size_t self) {
+    detail::current_pool_worker() = {this, self};
+    for (;;) {
+        if (run_one(self)) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+// A task owns [begin, end): it pushes upper halves until at most `chunk`
+// indices are left, runs those, and counts them as finished. Every pushed
+// task holds unfinished indices, so once all n are finished no task can
+// still reach f. A push that throws leaves its half with the task, which then
+// runs what it still owns chunk by chunk.
+template<typename F>
+void ThreadPool::parallel_for(size_t n, size_t chunk, F&& f) {
+    if (n == 0) return;
+    chunk = std::max<size_t>(chunk, 1);
+    if (n <= chunk || workers.empty()) {
+        for (size_t begin = 0; begin < n; begin += chunk) f(begin, std::min(n, begin + chunk));
+        return;
+    }
+
+    struct Job {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::exception_ptr error;    // Guarded by mutex
+        explicit Job(size_t count) : remaining(count) {}
+    };
+    auto job = std::make_shared<Job>(n);
+
+    // Recursive through a std::function so tasks can push further splits
+    auto run_range = std::make_shared<std::function<void(size_t, size_t)>>();
+    *run_range = [this, job, chunk, &f, weak = std::weak_ptr<std::function<void(size_t, size_t)>>(run_range)](
+                     size_t begin, size_t end) {
+        auto self = weak.lock();
+        while (end - begin > chunk) {
+            const size_t mid = begin + (end - begin) / 2;
+            try {
+                push([self, mid, end] { (*self)(mid, end); });
+            } catch (...) {
+                break;  // Could not queue the upper half: keep it
+            }
+            end = mid;
+        }
+        for (size_t at = begin; at < end; at += chunk) {
+            try {
+                f(at, std::min(end, at + chunk));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (!job->error) job->error = std::current_exception();
+            }
+        }
+        if (job->remaining.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin) notify_finished();
+    };
+
+    (*run_range)(0, n);
+    const size_t self = local_queue();
+    while (job->remaining.load(std::memory_order_acquire) != 0) {
+        if (run_one(self)) continue;
+        // The rest is running on other threads: sleep until it finishes or there is work to help with
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this, &job] {
+            return job->remaining.load(std::memory_order_acquire) == 0 || queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+    // Take the error out of the job: a worker may still drop the last reference
+    // to the job, and must not release the exception the caller is handling
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        error = std::move(job->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace myns
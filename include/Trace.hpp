@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+// Scoped trace events for MyContainer hot paths, exported as Chrome
+// trace-event JSON (opens in Perfetto and chrome://tracing).
+//
+// Define MYCONTAINER_ENABLE_TRACE to 1 before including MyContainer.hpp to
+// record events. Otherwise trace scopes are empty objects and cost nothing.
+#ifndef MYCONTAINER_ENABLE_TRACE
+#define MYCONTAINER_ENABLE_TRACE 0
+#endif
+
+namespace myns {
+namespace trace {
+
+constexpr bool enabled = MYCONTAINER_ENABLE_TRACE != 0;
+
+#if MYCONTAINER_ENABLE_TRACE
+
+// Events kept per thread; older events are overwritten once the ring is full
+constexpr size_t ring_capacity = 8192;
+
+namespace detail {
+
+// One completed scope. Fields are relaxed atomics so that a flush running
+// concurrently with the owning thread never reads a torn value; seq tells
+// the reader whether the slot still holds the event it expects.
+struct Event {
+    std::atomic<uint64_t> seq{0};  // Event index + 1 once written, 0 while being written
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> type{nullptr};  // Mangled type name from std::type_info
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> duration_ns{0};
+    std::atomic<uint64_t> elements{0};
+};
+
+// Single-producer ring buffer owned by one thread
+struct ThreadRing {
+    uint32_t tid;
+    std::atomic<uint64_t> head{0};  // Number of events ever written
+    std::atomic<bool> retired{false};  // Set when the owning thread exits
+    Event events[ring_capacity];
+
+    explicit ThreadRing(uint32_t id) : tid(id) {}
+
+    void push(const char* name, const char* type, uint64_t start, uint64_t duration, uint64_t elements) {
+        const uint64_t index = head.load(std::memory_order_relaxed);
+        Event& e = events[index % ring_capacity];
+        e.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.name.store(name, std::memory_order_relaxed);
+        e.type.store(type, std::memory_order_relaxed);
+        e.start_ns.store(start, std::memory_order_relaxed);
+        e.duration_ns.store(duration, std::memory_order_relaxed);
+        e.elements.store(elements, std::memory_order_relaxed);
+        e.seq.store(index + 1, std::memory_order_release);
+        head.store(index + 1, std::memory_order_release);
+    }
+};
+
+// Every live thread's ring, plus the rings of exited threads until the next
+// flush has written their events out
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    uint32_t next_tid = 1;  // Never reused, so events of different threads stay apart
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// Owns a thread's ring and marks it retired when the thread exits
+struct RingOwner {
+    std::shared_ptr<ThreadRing> ring;
+    ~RingOwner() { ring->retired.store(true, std::memory_order_release); }
+};
+
+// The calling thread's ring, registered on first use (the only locked step)
+inline ThreadRing& local_ring() {
+    thread_local RingOwner owner{[] {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto created = std::make_shared<ThreadRing>(r.next_tid++);
+        r.rings.push_back(created);
+        return created;
+    }()};
+    return *owner.ring;
+}
+
+// Removes the given rings from the registry; caller holds the registry mutex
+inline void drop_rings(Registry& r, const std::vector<const ThreadRing*>& dropped) {
+    if (dropped.empty()) return;
+    auto gone = [&dropped](const std::shared_ptr<ThreadRing>& ring) {
+        for (const ThreadRing* d : dropped) {
+            if (ring.get() == d) return true;
+        }
+        return false;
+    };
+    r.rings.erase(std::remove_if(r.rings.begin(), r.rings.end(), gone), r.rings.end());
+}
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().epoch).count());
+}
+
+inline std::string demangle(const char* mangled) {
+#if defined(__GNUG__)
+    int status = 0;
+    char* plain = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    if (status == 0 && plain) {
+        std::string out(plain);
+        std::free(plain);
+        return out;
+    }
+#endif
+    return mangled;
+}
+
+// Escapes a string for a JSON string literal: quotes, backslashes and control characters
+inline std::string json_escape(const std::string& s) {
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    for (char ch : s) {
+        const unsigned char u = static_cast<unsigned char>(ch);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if (u < 0x20) {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+        } else {
+            out += ch;
+        }
+    }
+    return out;
+}
+
+} // namespace detail
+
+//
+// Scope - records one complete ("X") event from construction to destruction
+//
+class Scope {
+    const char* name;
+    const char* type;
+    uint64_t elements;
+    uint64_t start;
+
+public:
+    Scope(const char* event_name, const std::type_info& element_type, size_t element_count)
+        : name(event_name), type(element_type.name()), elements(element_count), start(detail::now_ns()) {}
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+        detail::local_ring().push(name, type, start, detail::now_ns() - start, elements);
+    }
+};
+
+// Writes every buffered event as Chrome trace-event JSON. Rings of threads
+// that had exited before the flush started are dropped afterwards, so a
+// process that keeps starting threads does not keep every ring forever.
+inline void flush_chrome_json(std::ostream& os) {
+    detail::Registry& r = detail::registry();
+    std::vector<std::shared_ptr<detail::ThreadRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        rings = r.rings;
+    }
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    std::vector<const detail::ThreadRing*> finished;  // Every event written, and no more can come
+    for (const auto& ring : rings) {
+        if (ring->retired.load(std::memory_order_acquire)) finished.push_back(ring.get());
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t begin = head > ring_capacity ? head - ring_capacity : 0;
+        for (uint64_t i = begin; i < head; ++i) {
+            const detail::Event& e = ring->events[i % ring_capacity];
+            if (e.seq.load(std::memory_order_acquire) != i + 1) continue;
+            const char* name = e.name.load(std::memory_order_relaxed);
+            const char* type = e.type.load(std::memory_order_relaxed);
+            const uint64_t start = e.start_ns.load(std::memory_order_relaxed);
+            const uint64_t duration = e.duration_ns.load(std::memory_order_relaxed);
+            const uint64_t elements = e.elements.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.seq.load(std::memory_order_relaxed) != i + 1) continue;  // Overwritten while reading
+
+            os << (first ? "" : ",") << "\n{\"name\":\"" << detail::json_escape(name)
+               << "\",\"cat\":\"MyContainer\",\"ph\":\"X\""
+               << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << duration / 1000.0
+               << ",\"pid\":1,\"tid\":" << ring->tid << ",\"args\":{\"elements\":" << elements
+               << ",\"type\":\"" << detail::json_escape(detail::demangle(type)) << "\"}}";
+            first = false;
+        }
+    }
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+    detail::drop_rings(r, finished);
+}
+
+// Drops every buffered event, and the rings of threads that have exited
+inline void clear() {
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<const detail::ThreadRing*> finished;
+    for (auto& ring : r.rings) {
+        for (auto& e : ring->events) e.seq.store(0, std::memory_order_relaxed);
+        if (ring->retired.load(std::memory_order_acquire)) finished.push_back(ring.get());
+    }
+    detail::drop_rings(r, finished);
+}
+
+#else
+
+// Tracing compiled out: scopes are empty objects
+class Scope {
+public:
+    Scope(const char*, const std::type_info&, size_t) {}
+};
+
+inline void flush_chrome_json(std::ostream& os) { os << "{\"traceEvents\":[]}\n"; }
+inline void clear() {}
+
+#endif
+
+} // namespace trace
+} // namespace myns
@@ -0,0 +1,238 @@
+// Allocation budget tests for the MyContainer fast paths.
+//
+// This binary replaces the global operator new and, on glibc, malloc
+// (bench/alloc_counter.hpp), and checks the exact number of allocations each
+// operation performs in steady state, so an allocation added to one of these
+// paths fails `make test`.
+// It is built without the statistics, latency and trace hooks, as users get
+// the header by default.
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../include/doctest.h"
+#include "../bench/alloc_counter.hpp"
+#include "../include/MyContainer.hpp"
+#include "../include/ReadMostlyContainer.hpp"
+#include "../include/SideCrossQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace myns;
+
+// ========================= ELEMENT TYPES =========================
+
+struct Point {
+    int x, y;
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+    bool operator<(const Point& other) const { return (x < other.x) || (x == other.x && y < other.y); }
+    friend std::ostream& operator<<(std::ostream& os, const Point& p) {
+        return os << "(" << p.x << "," << p.y << ")";
+    }
+};
+
+// Maps an index to a value of T; strings stay short enough for the small-string buffer
+template<typename T> T make_value(int i);
+
+template<> int make_value<int>(int i) { return (i * 7919) % 101; }
+template<> double make_value<double>(int i) { return ((i * 7919) % 101) + 0.5; }
+template<> char make_value<char>(int i) { return static_cast<char>('a' + (i * 7) % 26); }
+template<> std::string make_value<std::string>(int i) { return std::to_string((i * 7919) % 101); }
+template<> Point make_value<Point>(int i) { return {(i * 7919) % 101, i}; }
+
+// Allocations made by one sort of a scratch vector, beyond the scratch copy itself.
+// Strings are sorted through a prefix-key array and a result vector; radix
+// sort falls back to std::sort on inputs this small.
+template<typename T> constexpr size_t sort_allocations = 0;
+template<> constexpr size_t sort_allocations<std::string> = 2;
+
+constexpr int element_count = 64;
+
+template<typename T>
+MyContainer<T> make_container() {
+    MyContainer<T> c;
+    for (int i = 0; i < element_count; ++i) c.add(make_value<T>(i));
+    return c;
+}
+
+// Allocations performed by f()
+template<typename F>
+size_t allocations_of(F&& f) {
+    const alloc_counter::Snapshot start = alloc_counter::now();
+    f();
+    return alloc_counter::since(start).allocations;
+}
+
+// Walks an order with operator* and operator++ only (no begin()/end() copies)
+template<typename Iterator>
+size_t walk(Iterator& it, size_t n) {
+    size_t touched = 0;
+    for (size_t i = 0; i < n; ++i, ++it) touched += sizeof(*it);
+    return touched;
+}
+
+#define ALLOC_TYPES int, double, char, std::string, Point
+
+// ========================= ALLOCATION BUDGETS =========================
+
+#if ALLOC_COUNTER_MALLOC
+TEST_CASE("malloc, calloc and realloc are counted alongside operator new") {
+    void* p = nullptr;
+    CHECK(allocations_of([&] { p = std::malloc(16); }) == 1);
+    CHECK(allocations_of([&] { p = std::realloc(p, 4096); }) == 1);
+    std::free(p);
+    CHECK(allocations_of([&] { p = std::calloc(4, 8); }) == 1);
+    std::free(p);
+    CHECK(allocations_of([&] { delete new int(1); }) == 1);  // Counted once, not by new and malloc both
+}
+#endif
+
+TEST_CASE_TEMPLATE("Element access does not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    const MyContainer<T>& cc = c;
+    size_t touched = 0;
+
+    CHECK(allocations_of([&] {
+        for (size_t i = 0; i < c.size(); ++i) touched += sizeof(c[i]) + sizeof(cc[i]);
+        for (size_t i = 0; i < c.size(); ++i) touched += sizeof(c.at(i)) + sizeof(cc.at(i));
+    }) == 0);
+    CHECK(touched > 0);
+}
+
+TEST_CASE_TEMPLATE("Order and ReverseOrder do not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    size_t visited = 0;
+
+    CHECK(allocations_of([&] {
+        for (const T& x : c.order()) visited += sizeof(x);
+        for (const T& x : c.reverse_order()) visited += sizeof(x);
+    }) == 0);
+    CHECK(visited == 2 * c.size() * sizeof(T));
+}
+
+TEST_CASE_TEMPLATE("add() within capacity and remove() do not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    const T extra = make_value<T>(element_count);
+    c.add(extra);
+    c.remove(extra);  // Leaves spare capacity for the next add
+
+    CHECK(allocations_of([&] { c.add(extra); }) == 0);
+    CHECK(allocations_of([&] { c.remove(extra); }) == 0);
+}
+
+TEST_CASE_TEMPLATE("splice() within capacity does not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    const T extra = make_value<T>(element_count);
+    std::vector<T> batch(element_count, extra);
+    c.splice(batch);
+    c.remove(extra);  // Leaves room for the next batch
+    batch.assign(element_count, extra);
+
+    CHECK(allocations_of([&] { c.splice(batch); }) == 0);
+    CHECK(batch.capacity() >= static_cast<size_t>(element_count));  // Kept for the next batch
+}
+
+TEST_CASE_TEMPLATE("snapshot() does not allocate; the next write copies once", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    const T extra = make_value<T>(element_count);
+
+    MyContainer<T> snap = c;
+    CHECK(allocations_of([&] { snap = c.snapshot(); }) == 0);
+    CHECK(allocations_of([&] { c.add(extra); }) == 2);  // Storage and its control block, in one go
+    CHECK(allocations_of([&] { c.add(extra); }) == 0);  // Detached: in place again
+}
+
+TEST_CASE_TEMPLATE("Sorted and arranged orders allocate only their scratch", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    const size_t n = c.size();
+
+    // One scratch vector and its shared block per order, plus whatever the sort for T needs
+    CHECK(allocations_of([&] { auto it = c.ascending_order(); }) == 2 + sort_allocations<T>);
+    CHECK(allocations_of([&] { auto it = c.descending_order(); }) == 2 + sort_allocations<T>);
+    CHECK(allocations_of([&] { auto it = c.sidecross_order(); }) == 3 + sort_allocations<T>);
+    CHECK(allocations_of([&] { auto it = c.middle_out_order(); }) == 2);
+
+    // Once built, traversal itself never allocates
+    auto asc = c.ascending_order();
+    auto desc = c.descending_order();
+    auto side = c.sidecross_order();
+    auto middle = c.middle_out_order();
+    CHECK(allocations_of([&] {
+        walk(asc, n);
+        walk(desc, n);
+        walk(side, n);
+        walk(middle, n);
+    }) == 0);
+    CHECK(allocations_of([&] { auto first = asc.begin(); auto last = asc.end(); }) == 0);  // Copies share the buffer
+}
+
+TEST_CASE_TEMPLATE("Radix sort allocates one buffer", T, int, double) {
+    MyContainer<T> c;
+    for (int i = 0; i < 4 * static_cast<int>(radix_sort::small_input); ++i) c.add(make_value<T>(i));
+
+    CHECK(allocations_of([&] { auto it = c.ascending_order(); }) == 3);
+    CHECK(allocations_of([&] { auto it = c.descending_order(); }) == 3);
+}
+
+TEST_CASE_TEMPLATE("chunk() and walking a slice do not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    auto asc = c.ascending_order();
+    auto middle = c.middle_out_order();
+    size_t visited = 0;
+
+    CHECK(allocations_of([&] {
+        for (size_t i = 0; i < 4; ++i) {
+            for (const T& x : asc.chunk(i, 4)) visited += sizeof(x);
+            for (const T& x : middle.chunk(i, 4)) visited += sizeof(x);
+        }
+    }) == 0);
+    CHECK(visited == 2 * c.size() * sizeof(T));
+    CHECK(allocations_of([&] { auto slices = asc.split(4); }) == 1);  // The vector of slices
+}
+
+TEST_CASE_TEMPLATE("SideCrossQueue push within capacity and pops do not allocate", T, ALLOC_TYPES) {
+    MyContainer<T> c = make_container<T>();
+    SideCrossQueue<T> q(c);
+    q.reserve(c.size() + 1);
+    const T extra = make_value<T>(element_count);
+    size_t popped = 0;
+
+    CHECK(allocations_of([&] {
+        q.push(extra);
+        q.pop_min();
+        q.pop_max();
+        for (popped = 2; !q.empty(); ++popped) q.pop_sidecross();
+    }) == 0);
+    CHECK(popped == c.size() + 1);
+}
+
+// ========================= ALLOCATION FAILURES =========================
+
+// A split that cannot be queued runs on the thread that split it instead of terminating
+TEST_CASE("parallel_for survives failing pushes") {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> hits(100000);
+    pool.parallel_for(hits.size(), 16, [&](size_t begin, size_t end) {
+        alloc_counter::allocations_before_failure = 0;  // Every later split from this thread fails
+        for (size_t i = begin; i < end; ++i) ++hits[i];
+    });
+    alloc_counter::allocations_before_failure = SIZE_MAX;  // The caller ran ranges too
+    CHECK(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }));
+}
+
+// A write that runs out of memory at any step leaves the published version as it was
+TEST_CASE("ReadMostlyContainer write failing on allocation publishes nothing") {
+    for (size_t budget = 0; budget < 16; ++budget) {
+        ReadMostlyContainer<int> c;
+        bool threw = false;
+        alloc_counter::allocations_before_failure = budget;
+        try {
+            c.add(1);
+        } catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        alloc_counter::allocations_before_failure = SIZE_MAX;
+        CHECK(c.size() == (threw ? 0u : 1u));
+    }
+}
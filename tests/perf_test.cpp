@@ -0,0 +1,269 @@
+// Large-scale performance tests for MyContainer.
+//
+// Runs every operation at 10^6 elements and above (10x per step, up to
+// --max-n) and checks two budgets per operation:
+//  * time per element must stay under a generous absolute limit, and must not
+//    grow by more than --max-growth between consecutive sizes. An O(n log n)
+//    operation grows by roughly 1.2x per 10x step, a quadratic one by 10x.
+//  * bytes allocated per element (counted by bench/alloc_counter.hpp) must
+//    stay under a multiple of sizeof(T), which catches copies per step.
+// The process exits with status 1 when any budget is exceeded.
+//
+// Usage: perf_test_bin [--min-n N] [--max-n N] [--max-growth FACTOR] [--filter TEXT]
+
+#include "../bench/alloc_counter.hpp"
+#include "../include/MyContainer.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace myns;
+
+// ========================= CUSTOM TYPE =========================
+
+struct Point {
+    int x, y;
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+    bool operator<(const Point& other) const { return (x < other.x) || (x == other.x && y < other.y); }
+    friend std::ostream& operator<<(std::ostream& os, const Point& p) {
+        return os << "(" << p.x << "," << p.y << ")";
+    }
+};
+
+// ========================= INPUT GENERATION =========================
+
+// Maps a key to a value of T, preserving key order
+template<typename T> T make_value(uint64_t key);
+
+template<> int make_value<int>(uint64_t key) { return static_cast<int>(key); }
+template<> double make_value<double>(uint64_t key) { return static_cast<double>(key) + 0.5; }
+template<> std::string make_value<std::string>(uint64_t key) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%012llu", static_cast<unsigned long long>(key));
+    return buf;  // 12 characters: fits the small-string buffer
+}
+template<> Point make_value<Point>(uint64_t key) {
+    return {static_cast<int>(key / 1000), static_cast<int>(key % 1000)};
+}
+
+// n random values drawn from [0, n), so most are distinct
+template<typename T>
+std::vector<T> make_values(size_t n) {
+    std::mt19937_64 rng(12345);
+    std::vector<T> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) values.push_back(make_value<T>(rng() % n));
+    return values;
+}
+
+// ========================= BUDGETS =========================
+
+struct Options {
+    size_t min_n = 1000000;
+    size_t max_n = 10000000;
+    double max_growth = 4.0;  // Allowed growth of ns/element per 10x step in n
+    std::string filter;
+};
+
+// Per-element limits for one operation
+struct Budget {
+    double ns_per_element;      // Absolute time limit
+    double copies_of_data;      // Allocated bytes limit, in units of sizeof(T) ...
+    double extra_bytes;         // ... plus this many bytes
+};
+
+constexpr Budget linear{500, 0.5, 0};     // Single pass over the data, no copies
+constexpr Budget copying{1000, 4.5, 0};   // Single pass plus scratch copies (and growth for add)
+constexpr Budget sorting{5000, 6, 0};     // Sort of scratch copies (strings add a key array)
+constexpr Budget hashing{5000, 4, 64};    // Hash aggregation: one node per distinct value
+
+// Number of values removed one at a time in the repeated-remove test
+constexpr size_t repeated_removes = 16;
+
+// Measured cost of one operation at one size
+struct Result {
+    double ns_per_element = 0;
+    double bytes_per_element = 0;
+};
+
+// Keeps the optimizer from discarding measured work
+volatile size_t sink = 0;
+
+// Peak resident set size of the process so far
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Times a single run of op, which touches `elements` elements in total
+template<typename Op>
+Result measure(size_t elements, Op op) {
+    using clock = std::chrono::steady_clock;
+    alloc_counter::Snapshot before = alloc_counter::now();
+    auto start = clock::now();
+    op();
+    auto stop = clock::now();
+    alloc_counter::Snapshot used = alloc_counter::since(before);
+
+    Result r;
+    r.ns_per_element = std::chrono::duration<double, std::nano>(stop - start).count() / elements;
+    r.bytes_per_element = static_cast<double>(used.bytes) / elements;
+    return r;
+}
+
+class PerfTest {
+    Options opt;
+    std::vector<std::pair<std::string, Result>> previous;  // Results at the previous size, by name
+    size_t failures = 0;
+
+public:
+    explicit PerfTest(Options o) : opt(std::move(o)) {}
+
+    const Options& options() const { return opt; }
+    bool passed() const { return failures == 0; }
+
+    bool wanted(const std::string& op) const {
+        return opt.filter.empty() || op.find(opt.filter) != std::string::npos;
+    }
+
+    // Records one result and checks it against its budget and the previous size
+    void check(const char* type, size_t n, const char* op, size_t element_size, Budget budget, Result r) {
+        const std::string name = std::string(type) + "/" + op;
+        std::string verdict;
+        if (r.ns_per_element > budget.ns_per_element) verdict += " time-budget";
+        if (r.bytes_per_element > budget.copies_of_data * element_size + budget.extra_bytes) verdict += " memory-budget";
+        for (auto& entry : previous) {
+            if (entry.first != name) continue;
+            if (r.ns_per_element > opt.max_growth * entry.second.ns_per_element) verdict += " complexity";
+            entry.second = r;
+        }
+        if (!std::any_of(previous.begin(), previous.end(), [&](const auto& e) { return e.first == name; })) {
+            previous.emplace_back(name, r);
+        }
+
+        std::printf("%-8s %10zu  %-24s %10.2f %12.1f %10ld  %s\n", type, n, op, r.ns_per_element,
+                    r.bytes_per_element, peak_rss_kb(), verdict.empty() ? "ok" : ("FAIL" + verdict).c_str());
+        if (!verdict.empty()) ++failures;
+    }
+};
+
+// Constructs an order and traverses it with a range-for loop
+template<typename T, typename MakeOrder>
+void test_order(PerfTest& t, const char* type, const MyContainer<T>& c, const char* op, Budget budget,
+                MakeOrder make_order) {
+    if (!t.wanted(op)) return;
+    Result r = measure(c.size(), [&] {
+        size_t count = 0;
+        for (const auto& x : make_order()) { (void)x; ++count; }
+        sink = sink + count;
+    });
+    t.check(type, c.size(), op, sizeof(T), budget, r);
+}
+
+// Same, but the loop calls end() on every step, so an end() that copies turns quadratic
+template<typename T, typename MakeOrder>
+void test_order_end_loop(PerfTest& t, const char* type, const MyContainer<T>& c, const char* op, Budget budget,
+                         MakeOrder make_order) {
+    if (!t.wanted(op)) return;
+    Result r = measure(c.size(), [&] {
+        size_t count = 0;
+        auto order = make_order();
+        for (auto it = order.begin(); it != order.end(); ++it) { (void)*it; ++count; }
+        sink = sink + count;
+    });
+    t.check(type, c.size(), op, sizeof(T), budget, r);
+}
+
+template<typename T>
+void test_type(PerfTest& t, const char* type, size_t n) {
+    const std::vector<T> values = make_values<T>(n);
+
+    MyContainer<T> c;
+    if (t.wanted("add")) {
+        Result r = measure(n, [&] {
+            for (const T& v : values) c.add(v);
+        });
+        t.check(type, n, "add", sizeof(T), copying, r);
+    } else {
+        for (const T& v : values) c.add(v);
+    }
+
+    if (t.wanted("remove")) {
+        MyContainer<T> copy(c.get_data());  // Own storage, so remove() works in place
+        Result r = measure(n, [&] { copy.remove(values[n / 2]); });
+        t.check(type, n, "remove", sizeof(T), linear, r);
+    }
+
+    // Removing values one at a time costs one pass each, never more
+    if (t.wanted("remove_repeated")) {
+        MyContainer<T> copy(c.get_data());  // Own storage, so remove() works in place
+        Result r = measure(n * repeated_removes, [&] {
+            for (size_t i = 0; i < repeated_removes; ++i) {
+                try {
+                    copy.remove(values[i * (n / repeated_removes)]);
+                } catch (const std::runtime_error&) {
+                    // Already removed with an earlier duplicate; the miss still scans once
+                }
+            }
+        });
+        t.check(type, n, "remove_repeated", sizeof(T), linear, r);
+    }
+
+    test_order(t, type, c, "ascending_order", sorting, [&] { return c.ascending_order(); });
+    test_order(t, type, c, "descending_order", sorting, [&] { return c.descending_order(); });
+    test_order(t, type, c, "sidecross_order", sorting, [&] { return c.sidecross_order(); });
+    test_order(t, type, c, "reverse_order", linear, [&] { return c.reverse_order(); });
+    test_order(t, type, c, "order", linear, [&] { return c.order(); });
+    test_order(t, type, c, "middle_out_order", copying, [&] { return c.middle_out_order(); });
+    test_order(t, type, c, "grouped_ascending_order", hashing, [&] { return c.grouped_ascending_order(); });
+    test_order(t, type, c, "distinct_order", hashing, [&] { return c.distinct_order(); });
+    test_order(t, type, c, "frequency_order", hashing, [&] { return c.frequency_order(); });
+    test_order_end_loop(t, type, c, "ascending_end_loop", sorting, [&] { return c.ascending_order(); });
+    test_order_end_loop(t, type, c, "descending_end_loop", sorting, [&] { return c.descending_order(); });
+    test_order_end_loop(t, type, c, "sidecross_end_loop", sorting, [&] { return c.sidecross_order(); });
+    test_order_end_loop(t, type, c, "middle_out_end_loop", copying, [&] { return c.middle_out_order(); });
+
+    if (t.wanted("memory_usage")) {
+        MemoryUsage m = c.memory_usage();
+        Result r;
+        r.bytes_per_element = static_cast<double>(m.total()) / n;  // Resident footprint, not allocations
+        t.check(type, n, "memory_usage", sizeof(T), Budget{1e9, 2.5, 0}, r);
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--min-n" && has_value) opt.min_n = std::stoull(argv[++i]);
+        else if (arg == "--max-n" && has_value) opt.max_n = std::stoull(argv[++i]);
+        else if (arg == "--max-growth" && has_value) opt.max_growth = std::stod(argv[++i]);
+        else if (arg == "--filter" && has_value) opt.filter = argv[++i];
+        else {
+            std::fprintf(stderr, "Usage: %s [--min-n N] [--max-n N] [--max-growth FACTOR] [--filter TEXT]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    PerfTest t(opt);
+    std::printf("%-8s %10s  %-24s %10s %12s %10s  %s\n", "type", "n", "operation", "ns/elem",
+                "bytes/elem", "rss_kb", "result");
+    for (size_t n = opt.min_n; n <= opt.max_n; n *= 10) {
+        test_type<int>(t, "int", n);
+        test_type<double>(t, "double", n);
+        test_type<std::string>(t, "string", n);
+        test_type<Point>(t, "Point", n);
+    }
+
+    std::printf("%s\n", t.passed() ? "All performance budgets met" : "Performance budgets exceeded");
+    return t.passed() ? 0 : 1;
+}
@@ -1,8 +1,20 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define MYCONTAINER_ENABLE_STATS 1    // Run the suite with operation statistics compiled in
+#define MYCONTAINER_ENABLE_LATENCY 1  // ... and latency histograms
+#define MYCONTAINER_ENABLE_TRACE 1    // ... and trace events
 #include "../include/doctest.h"
 #include "../include/MyContainer.hpp"
+#include "../include/ConcurrentContainer.hpp"
+#include "../include/ReadMostlyContainer.hpp"
+#include "../include/ShardedContainer.hpp"
+#include "../include/StagingBuffers.hpp"
+#include "../include/ParallelAlgorithms.hpp"
+#include "../include/SideCrossQueue.hpp"
+#include "../include/PrecomputedContainer.hpp"
+#include <set>
 #include <sstream>
 #include <cmath>
+#include <thread>
 
 using namespace myns;
 
@@ -474,3 +486,1347 @@ TEST_CASE("Iterators with a single string element") {
     for (auto x : c.middle_out_order()) actual.push_back(x);
     CHECK(actual == expected);
 }
+
+// Test prefix-key string sorting on ties, shared prefixes and non-ASCII bytes
+TEST_CASE("String sorting with shared 8-byte prefixes") {
+    MyContainer<std::string> c;
+    std::vector<std::string> input = {
+        "prefix__zeta", "prefix__alpha", "prefix__", "prefix_", "prefix__alpha",
+        std::string("ab\0c", 4), "ab", "\xff\xfe", "\x7f", "", "prefix__beta"
+    };
+    for (const auto& s : input) c.add(s);
+
+    std::vector<std::string> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> asc, desc;
+    for (auto x : c.ascending_order()) asc.push_back(x);
+    for (auto x : c.descending_order()) desc.push_back(x);
+    CHECK(asc == expected);
+
+    std::reverse(expected.begin(), expected.end());
+    CHECK(desc == expected);
+}
+
+// ========================= SORT STRATEGIES =========================
+
+// Element type with its own sort backend, registered through sort_traits
+struct Version {
+    int major, minor;
+    bool operator==(const Version& other) const { return major == other.major && minor == other.minor; }
+    bool operator<(const Version& other) const {
+        return major < other.major || (major == other.major && minor < other.minor);
+    }
+};
+
+// Sorts Versions on a packed integer key and counts how often it runs
+struct VersionSort {
+    static inline int calls = 0;
+    static void sort(std::vector<Version>& v) {
+        ++calls;
+        std::sort(v.begin(), v.end(), [](const Version& a, const Version& b) {
+            return (static_cast<long>(a.major) << 32 | static_cast<unsigned>(a.minor)) <
+                   (static_cast<long>(b.major) << 32 | static_cast<unsigned>(b.minor));
+        });
+    }
+};
+
+template<>
+struct myns::sort_traits<Version> {
+    using backend = VersionSort;
+};
+
+// Test that each element type gets the expected backend at compile time
+TEST_CASE("sort_traits selects a backend per type") {
+    CHECK(std::is_same<sort_backend_t<char>, counting_sort>::value);
+    CHECK(std::is_same<sort_backend_t<unsigned char>, counting_sort>::value);
+    CHECK(std::is_same<sort_backend_t<int>, radix_sort>::value);
+    CHECK(std::is_same<sort_backend_t<unsigned long long>, radix_sort>::value);
+    CHECK(std::is_same<sort_backend_t<double>, radix_sort>::value);
+    CHECK(std::is_same<sort_backend_t<std::string>, prefix_key_sort>::value);
+    CHECK(std::is_same<sort_backend_t<Point>, comparison_sort>::value);
+    CHECK(std::is_same<sort_backend_t<Version>, VersionSort>::value);
+}
+
+// Test counting sort on signed chars, including negative values
+TEST_CASE("Counting sort for char") {
+    MyContainer<char> c;
+    std::vector<char> expected;
+    for (int i = 0; i < 300; ++i) {
+        char x = static_cast<char>((i * 97) % 256 - 128);
+        c.add(x);
+        expected.push_back(x);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<char> asc, desc;
+    for (auto x : c.ascending_order()) asc.push_back(x);
+    for (auto x : c.descending_order()) desc.push_back(x);
+    CHECK(asc == expected);
+    std::reverse(expected.begin(), expected.end());
+    CHECK(desc == expected);
+}
+
+// Test radix sort on signed integers and doubles, large enough to skip the small-input fallback
+TEST_CASE("Radix sort for integers and doubles") {
+    MyContainer<long long> ints;
+    MyContainer<double> doubles;
+    std::vector<long long> expected_ints;
+    std::vector<double> expected_doubles;
+    for (long long i = 0; i < 1000; ++i) {
+        long long x = (i * 2654435761LL) % 1000003 - 500000;
+        if (i == 0) x = std::numeric_limits<long long>::min();
+        if (i == 1) x = std::numeric_limits<long long>::max();
+        ints.add(x);
+        expected_ints.push_back(x);
+
+        double d = static_cast<double>(x % 1000) / 7.0;
+        if (i == 2) d = -std::numeric_limits<double>::infinity();
+        if (i == 3) d = std::numeric_limits<double>::infinity();
+        doubles.add(d);
+        expected_doubles.push_back(d);
+    }
+    std::sort(expected_ints.begin(), expected_ints.end());
+    std::sort(expected_doubles.begin(), expected_doubles.end());
+
+    std::vector<long long> asc_ints;
+    std::vector<double> asc_doubles;
+    for (auto x : ints.ascending_order()) asc_ints.push_back(x);
+    for (auto x : doubles.ascending_order()) asc_doubles.push_back(x);
+    CHECK(asc_ints == expected_ints);
+    CHECK(asc_doubles == expected_doubles);
+}
+
+// Test that a backend registered for a user type is used by every sorted order
+TEST_CASE("Custom sort backend through sort_traits") {
+    MyContainer<Version> c;
+    c.add({2, 0});
+    c.add({1, 9});
+    c.add({1, 10});
+
+    VersionSort::calls = 0;
+    std::vector<Version> asc;
+    for (auto v : c.ascending_order()) asc.push_back(v);
+    auto desc = c.descending_order();
+    auto cross = c.sidecross_order();
+    CHECK(VersionSort::calls == 3);
+    CHECK(asc == std::vector<Version>{{1, 9}, {1, 10}, {2, 0}});
+    CHECK((*desc.begin() == Version{2, 0}));
+    CHECK((*cross.begin() == Version{1, 9}));
+}
+
+// ========================= COMPARATORS AND PROJECTIONS =========================
+
+// Test sorted iterators with a custom comparator
+TEST_CASE("Sorted iterators with a custom comparator") {
+    MyContainer<int> c;
+    for (int x : {5, -7, 2, -1, 9}) c.add(x);
+    auto by_abs = [](int a, int b) { return std::abs(a) < std::abs(b); };
+
+    std::vector<int> asc, desc, cross;
+    for (auto x : c.ascending_order(by_abs)) asc.push_back(x);
+    for (auto x : c.descending_order(by_abs)) desc.push_back(x);
+    for (auto x : c.sidecross_order(by_abs)) cross.push_back(x);
+
+    CHECK(asc == std::vector<int>{-1, 2, 5, -7, 9});
+    CHECK(desc == std::vector<int>{9, -7, 5, 2, -1});
+    CHECK(cross == std::vector<int>{-1, 9, 2, -7, 5});
+}
+
+// Test sorting Points by a projected key, with ties kept in insertion order
+TEST_CASE("Sorted iterators with a projection") {
+    MyContainer<Point> c;
+    c.add({5, 0});
+    c.add({1, 1});
+    c.add({0, 5});
+    c.add({3, 4});
+
+    std::vector<Point> asc, desc;
+    for (auto p : c.ascending_order(&Point::sum)) asc.push_back(p);
+    for (auto p : c.descending_order([](const Point& p) { return p.sum(); })) desc.push_back(p);
+
+    CHECK(asc == std::vector<Point>{{1, 1}, {5, 0}, {0, 5}, {3, 4}});
+    CHECK(desc == std::vector<Point>{{3, 4}, {5, 0}, {0, 5}, {1, 1}});
+}
+
+// Test that a projection is evaluated once per element
+TEST_CASE("Projection is computed once per element") {
+    MyContainer<int> c;
+    for (int i = 0; i < 100; ++i) c.add((i * 37) % 100);
+    size_t calls = 0;
+    auto proj = [&calls](int x) { ++calls; return -x; };
+
+    std::vector<int> actual;
+    for (auto x : c.ascending_order(proj)) actual.push_back(x);
+    CHECK(calls == 100);
+    CHECK(actual.front() == 99);
+    CHECK(actual.back() == 0);
+}
+
+// Test sorting pointers by the pointed-to value through a projection
+TEST_CASE("Pointer container sorted by pointee through a projection") {
+    Point* p1 = new Point{3, 3};
+    Point* p2 = new Point{1, 1};
+    Point* p3 = new Point{2, 2};
+
+    MyContainer<Point*> c;
+    c.add(p1);
+    c.add(p2);
+    c.add(p3);
+
+    std::vector<Point*> actual;
+    for (auto p : c.ascending_order([](const Point* p) { return *p; })) actual.push_back(p);
+    CHECK(actual == std::vector<Point*>{p2, p3, p1});
+
+    delete p1;
+    delete p2;
+    delete p3;
+}
+
+// Test the pointee-ordered mode for pointer containers
+TEST_CASE("Pointer container sorted with by_pointee") {
+    std::vector<Point*> points;
+    MyContainer<Point*> c;
+    for (int i = 0; i < 20; ++i) {
+        points.push_back(new Point{(i * 7) % 20, i});
+        c.add(points.back());
+    }
+
+    std::vector<int> asc, desc;
+    for (auto p : c.ascending_order(by_pointee)) asc.push_back(p->x);
+    for (auto p : c.descending_order(by_pointee)) desc.push_back(p->x);
+
+    for (int i = 0; i < 20; ++i) {
+        CHECK(asc[i] == i);
+        CHECK(desc[i] == 19 - i);
+    }
+
+    // Null pointers cannot be ordered by pointee
+    c.add(nullptr);
+    CHECK_THROWS_AS(c.ascending_order(by_pointee), std::runtime_error);
+
+    for (Point* p : points) delete p;
+}
+
+// ========================= GROUPED AND DISTINCT ORDERS =========================
+
+// Test run-length grouping with a hashable type
+TEST_CASE("GroupedAscendingOrder and DistinctOrder with duplicates") {
+    MyContainer<int> c;
+    for (int x : {4, 1, 4, 2, 1, 4, 9}) c.add(x);
+
+    std::vector<std::pair<int, size_t>> groups;
+    for (const auto& g : c.grouped_ascending_order()) groups.push_back(g);
+    CHECK(groups == std::vector<std::pair<int, size_t>>{{1, 2}, {2, 1}, {4, 3}, {9, 1}});
+
+    std::vector<int> distinct;
+    for (auto x : c.distinct_order()) distinct.push_back(x);
+    CHECK(distinct == std::vector<int>{1, 2, 4, 9});
+}
+
+// Test grouping with a type that has no std::hash (sort-based fallback)
+TEST_CASE("GroupedAscendingOrder with non-hashable Point") {
+    MyContainer<Point> c;
+    c.add({1, 1});
+    c.add({0, 2});
+    c.add({1, 1});
+
+    std::vector<std::pair<Point, size_t>> groups;
+    for (const auto& g : c.grouped_ascending_order()) groups.push_back(g);
+    REQUIRE(groups.size() == 2);
+    CHECK(groups[0].first == Point{0, 2});
+    CHECK(groups[0].second == 1);
+    CHECK(groups[1].first == Point{1, 1});
+    CHECK(groups[1].second == 2);
+}
+
+// Grouped and distinct orders on empty and string containers
+TEST_CASE("GroupedAscendingOrder and DistinctOrder with strings and empty container") {
+    MyContainer<std::string> c;
+    CHECK(c.grouped_ascending_order().begin() == c.grouped_ascending_order().end());
+    CHECK(c.distinct_order().begin() == c.distinct_order().end());
+
+    for (const char* s : {"b", "a", "b", "", "b"}) c.add(s);
+    std::vector<std::string> distinct;
+    for (auto x : c.distinct_order()) distinct.push_back(x);
+    CHECK(distinct == std::vector<std::string>{"", "a", "b"});
+    CHECK((*c.grouped_ascending_order().begin()).second == 1);
+}
+
+// ========================= FREQUENCY ORDER =========================
+
+// Test most-common-first ordering with ties broken by value
+TEST_CASE("FrequencyOrder ranks values by count") {
+    MyContainer<int> c;
+    for (int x : {5, 3, 5, 7, 3, 5, 1, 7}) c.add(x);
+
+    std::vector<std::pair<int, size_t>> all;
+    for (const auto& g : c.frequency_order()) all.push_back(g);
+    CHECK(all == std::vector<std::pair<int, size_t>>{{5, 3}, {3, 2}, {7, 2}, {1, 1}});
+
+    std::vector<std::pair<int, size_t>> top2;
+    for (const auto& g : c.frequency_order(2)) top2.push_back(g);
+    CHECK(top2 == std::vector<std::pair<int, size_t>>{{5, 3}, {3, 2}});
+
+    CHECK(c.frequency_order(0).begin() == c.frequency_order(0).end());
+}
+
+// Test frequency ranking with strings and the non-hashable fallback
+TEST_CASE("FrequencyOrder with strings and Points") {
+    MyContainer<std::string> s;
+    for (const char* x : {"get", "put", "get", "del", "get", "put"}) s.add(x);
+    auto top = s.frequency_order(1).begin();
+    CHECK((*top).first == "get");
+    CHECK((*top).second == 3);
+
+    MyContainer<Point> p;
+    p.add({2, 2});
+    p.add({1, 1});
+    p.add({2, 2});
+    CHECK((*p.frequency_order().begin()).first == Point{2, 2});
+}
+
+// ========================= OPERATION STATISTICS =========================
+
+// Test that add, remove, order construction and scratch copies are counted
+TEST_CASE("Operation statistics") {
+    MyContainer<int> c;
+    CHECK(MyContainer<int>::stats_enabled);
+    for (int x : {3, 1, 2, 1}) c.add(x);
+    c.remove(1);
+    CHECK_THROWS(c.remove(42));
+
+    for (auto x : c.ascending_order()) (void)x;
+    for (auto x : c.sidecross_order()) (void)x;
+    for (auto x : c.order()) (void)x;
+
+    ContainerStats s = c.stats();
+    CHECK(s.adds == 4);
+    CHECK(s.removes == 1);
+    CHECK(s.remove_misses == 1);
+    CHECK(s.constructions(OrderKind::Ascending) == 1);
+    CHECK(s.constructions(OrderKind::SideCross) == 1);
+    CHECK(s.constructions(OrderKind::Order) == 1);
+    CHECK(s.constructions(OrderKind::Descending) == 0);
+    CHECK(s.elements_copied == 2 + 2 * 2);  // Ascending copy + side-cross sorted and arranged copies
+    CHECK(s.sorts == 2);
+    CHECK(s.bytes_allocated >= 4 * sizeof(int));
+
+    // Copies start with fresh statistics
+    MyContainer<int> copy = c;
+    CHECK(copy.stats().adds == 0);
+
+    c.reset_stats();
+    CHECK(c.stats().adds == 0);
+    CHECK(c.stats().sorts == 0);
+}
+
+// ========================= LATENCY HISTOGRAMS =========================
+
+// Test bucket boundaries and percentiles of the log-bucketed histogram
+TEST_CASE("LatencyHistogram buckets and percentiles") {
+    CHECK(LatencyHistogram::bucket_index(0) == 0);
+    CHECK(LatencyHistogram::bucket_index(15) == 15);
+    CHECK(LatencyHistogram::bucket_upper(LatencyHistogram::bucket_index(1000)) >= 1000);
+    CHECK(LatencyHistogram::bucket_upper(LatencyHistogram::bucket_index(1000)) <= 1125);  // Within 12.5%
+
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    LatencyHistogram::Summary s = h.summary();
+    CHECK(s.count == 1000);
+    CHECK(s.max_ns == 1000);
+    CHECK(s.mean_ns == doctest::Approx(500.5));
+    CHECK(s.p50_ns >= 500);
+    CHECK(s.p50_ns <= 563);
+    CHECK(s.p99_ns >= 990);
+    CHECK(s.p99_ns <= 1000);
+
+    h.reset();
+    CHECK(h.summary().count == 0);
+
+    // More recording threads than stripes share stripes, and nothing is lost
+    CHECK(h.stripe_count() == std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                               LatencyHistogram::max_stripes));
+    CHECK(h.footprint_bytes() <= LatencyHistogram::max_stripes * 2560);  // The README's per-histogram bound
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < h.stripe_count() + 3; ++t) {
+        writers.emplace_back([&h] {
+            for (uint64_t v = 1; v <= 100; ++v) h.record(v);
+        });
+    }
+    for (auto& w : writers) w.join();
+    CHECK(h.summary().count == 100 * (h.stripe_count() + 3));
+    CHECK(h.summary().max_ns == 100);
+}
+
+// Test that container operations feed their histograms and can be dumped
+TEST_CASE("Container latency histograms") {
+    MyContainer<int> c;
+    CHECK(MyContainer<int>::latency_enabled);
+    for (int i = 0; i < 100; ++i) c.add(i);
+    c.remove(5);
+    for (auto x : c.ascending_order()) (void)x;
+
+    CHECK(c.latency(LatencyOp::Add).count == 100);
+    CHECK(c.latency(LatencyOp::Remove).count == 1);
+    CHECK(c.latency(latency_op(OrderKind::Ascending)).count == 1);
+    CHECK(c.latency(LatencyOp::Descending).count == 0);
+    CHECK(c.latency(LatencyOp::Add).p50_ns <= c.latency(LatencyOp::Add).p99_ns);
+
+    std::ostringstream oss;
+    c.dump_latency(oss);
+    CHECK(oss.str().find("add: count=100") != std::string::npos);
+    CHECK(oss.str().find("descending_order") == std::string::npos);
+
+    c.reset_latency();
+    CHECK(c.latency(LatencyOp::Add).count == 0);
+}
+
+// ========================= TRACE EXPORT =========================
+
+// Test that hot paths emit Chrome trace events with element count and type
+TEST_CASE("Trace events exported as Chrome trace JSON") {
+    trace::clear();
+    MyContainer<std::string> c;
+    c.add("b");
+    c.add("a");
+    for (auto x : c.ascending_order()) (void)x;
+
+    // Events from another thread land in that thread's ring
+    std::thread worker([] {
+        MyContainer<int> other;
+        other.add(1);
+    });
+    worker.join();
+
+    std::ostringstream oss;
+    trace::flush_chrome_json(oss);
+    const std::string json = oss.str();
+    CHECK(json.find("{\"traceEvents\":[") == 0);
+    CHECK(json.find("\"name\":\"add\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"ascending_order\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"sort\"") != std::string::npos);
+    CHECK(json.find("\"elements\":2") != std::string::npos);
+    CHECK(json.find("\"type\":\"int\"") != std::string::npos);
+    CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+
+    trace::clear();
+    std::ostringstream empty;
+    trace::flush_chrome_json(empty);
+    CHECK(empty.str().find("\"name\"") == std::string::npos);
+}
+
+// Test that names and types are escaped, control characters included
+TEST_CASE("Trace JSON escapes quotes, backslashes and control characters") {
+    CHECK(trace::detail::json_escape("a\"b\\c") == "a\\\"b\\\\c");
+    CHECK(trace::detail::json_escape("tab\there\nnl\x01") == "tab\\u0009here\\u000anl\\u0001");
+    CHECK(trace::detail::json_escape("plain") == "plain");
+
+    trace::clear();
+    { trace::Scope scope("odd \"name\"\n", typeid(int), 1); }
+    std::ostringstream oss;
+    trace::flush_chrome_json(oss);
+    CHECK(oss.str().find("\"name\":\"odd \\\"name\\\"\\u000a\"") != std::string::npos);
+    trace::clear();
+}
+
+// Test that rings of exited threads are released after the flush that writes them
+TEST_CASE("Trace rings of exited threads are released") {
+    auto ring_count = [] {
+        trace::detail::Registry& r = trace::detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return r.rings.size();
+    };
+    trace::clear();
+    const size_t before = ring_count();
+
+    for (int t = 0; t < 8; ++t) {
+        std::thread worker([] {
+            MyContainer<int> other;
+            other.add(7);
+        });
+        worker.join();
+    }
+    CHECK(ring_count() == before + 8);  // Kept until flushed
+
+    std::ostringstream oss;
+    trace::flush_chrome_json(oss);
+    size_t adds = 0;
+    for (size_t at = oss.str().find("\"name\":\"add\""); at != std::string::npos;
+         at = oss.str().find("\"name\":\"add\"", at + 1)) {
+        ++adds;
+    }
+    CHECK(adds == 8);
+    CHECK(ring_count() == before);
+}
+
+TEST_CASE("Memory usage accounting") {
+    MyContainer<int> c;
+    for (int i = 0; i < 5; ++i) c.add(i);
+    MemoryUsage m = c.memory_usage();
+    CHECK(m.storage_bytes == 5 * sizeof(int));
+    CHECK(m.slack_bytes == (c.get_data().capacity() - 5) * sizeof(int));
+    CHECK(m.iterator_scratch_bytes == 0);
+    CHECK(m.element_heap_bytes == 0);
+    CHECK(m.total() == c.get_data().capacity() * sizeof(int));
+
+    {
+        auto asc = c.ascending_order();
+        size_t held = c.memory_usage().iterator_scratch_bytes;
+        CHECK(held >= 5 * sizeof(int));
+        auto it = asc.begin();  // Copies share the arranged buffer
+        CHECK(c.memory_usage().iterator_scratch_bytes == held);
+        (void)it;
+    }
+    CHECK(c.memory_usage().iterator_scratch_bytes == 0);  // Released with the iterators
+
+    c.shrink_to_fit();
+    CHECK(c.memory_usage().slack_bytes == 0);
+
+    MyContainer<std::string> s;
+    s.add("a");
+    s.add(std::string(100, 'x'));
+    CHECK(s.memory_usage().element_heap_bytes >= 101);
+}
+
+// Test that an order may outlive its container and that each copy counts its own scratch
+TEST_CASE("Orders outliving their container") {
+    auto make = [] { MyContainer<int> t; t.add(3); t.add(1); t.add(2); return t; };
+    std::vector<int> seen;
+    for (int x : make().ascending_order()) seen.push_back(x);  // Temporary dies before the loop body
+    CHECK(seen == std::vector<int>{1, 2, 3});
+
+    MyContainer<int> c = make();
+    {
+        auto snap = c.snapshot();
+        auto desc = snap.descending_order();
+        CHECK(snap.memory_usage().iterator_scratch_bytes >= 3 * sizeof(int));
+        CHECK(c.memory_usage().iterator_scratch_bytes == 0);  // The original holds no iterator
+        MyContainer<int> copy = snap;
+        CHECK(copy.memory_usage().iterator_scratch_bytes == 0);
+    }
+}
+
+TEST_CASE("Growth factor") {
+    MyContainer<int> c;
+    CHECK(c.growth_factor() == 2.0);
+    CHECK_THROWS_AS(c.set_growth_factor(1.0), std::invalid_argument);
+    CHECK_THROWS_AS(c.set_growth_factor(0.5), std::invalid_argument);
+
+    c.set_growth_factor(1.5);
+    for (int i = 0; i < 100; ++i) c.add(i);
+    size_t cap = c.get_data().capacity();
+    CHECK(cap >= 100);
+    CHECK(cap < 100 * 3 / 2 + 2);  // Never more than one factor of slack
+    CHECK(c.size() == 100);
+}
+
+// ========================= CONCURRENT CONTAINER =========================
+
+// Test appends from several producer threads: every value lands exactly once
+TEST_CASE("ConcurrentContainer with concurrent producers") {
+    ConcurrentContainer<int> c;
+    const int producers = 4;
+    const int per_producer = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&c, t] {
+            for (int i = 0; i < per_producer; ++i) c.add(t * per_producer + i);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    CHECK(c.size() == static_cast<size_t>(producers * per_producer));
+    std::vector<int> seen;
+    MyContainer<int> snap = c.snapshot();  // Orders refer to their container, so keep it alive
+    for (auto x : snap.ascending_order()) seen.push_back(x);
+    std::vector<int> expected(producers * per_producer);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(seen == expected);
+    CHECK_THROWS_AS(c.at(c.size()), std::out_of_range);
+}
+
+// Test that a reader running alongside producers only sees fully built elements
+TEST_CASE("ConcurrentContainer readers see a consistent prefix") {
+    ConcurrentContainer<std::string> c;
+    const size_t total = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (size_t i = 0; i < total; ++i) c.add(std::string(20, static_cast<char>('a' + i % 26)));
+        done = true;
+    });
+
+    bool consistent = true;
+    size_t last = 0;
+    while (!done) {
+        const size_t n = c.size();
+        if (n < last) consistent = false;  // The published size never shrinks
+        last = n;
+        if (n > 0 && c[n - 1] != std::string(20, static_cast<char>('a' + (n - 1) % 26))) consistent = false;
+    }
+    producer.join();
+
+    CHECK(consistent);
+    CHECK(c.size() == total);
+    CHECK(c.snapshot().size() == total);
+}
+
+// Test the six orders over a snapshot, across several segments
+TEST_CASE("ConcurrentContainer orders run over a snapshot") {
+    ConcurrentContainer<int> c;
+    MyContainer<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        c.add((i * 37) % 100);
+        expected.add((i * 37) % 100);
+    }
+
+    MyContainer<int> snap = c.snapshot();
+    c.add(1000);  // Not part of the snapshot
+    CHECK(snap.get_data() == expected.get_data());
+
+    std::vector<int> a, b;
+    for (auto x : snap.sidecross_order()) a.push_back(x);
+    for (auto x : expected.sidecross_order()) b.push_back(x);
+    CHECK(a == b);
+
+    a.clear();
+    b.clear();
+    for (auto x : snap.middle_out_order()) a.push_back(x);
+    for (auto x : expected.middle_out_order()) b.push_back(x);
+    CHECK(a == b);
+    CHECK(c.size() == 101);
+    CHECK(c[100] == 1000);
+}
+
+// Copying a negative value throws, to exercise a failing add()
+struct FragileCopy {
+    int v;
+    explicit FragileCopy(int value) : v(value) {}
+    FragileCopy(const FragileCopy& other) : v(other.v) {
+        if (v < 0) throw std::runtime_error("copy refused");
+    }
+    FragileCopy& operator=(const FragileCopy&) = default;
+    bool operator==(const FragileCopy& other) const { return v == other.v; }
+    bool operator<(const FragileCopy& other) const { return v < other.v; }
+    friend std::ostream& operator<<(std::ostream& os, const FragileCopy& f) { return os << f.v; }
+};
+
+// Test that a throwing copy loses its slot without holding back later elements
+TEST_CASE("ConcurrentContainer add() with a throwing copy") {
+    ConcurrentContainer<FragileCopy> c;
+    c.add(FragileCopy(1));
+    CHECK_THROWS_AS(c.add(FragileCopy(-1)), std::runtime_error);
+    c.add(FragileCopy(2));
+
+    CHECK(c.size() == 3);  // The lost slot still counts
+    CHECK(c.at(0).v == 1);
+    CHECK_THROWS_AS(c.at(1), std::runtime_error);
+    CHECK(c.at(2).v == 2);
+    CHECK(c.snapshot().get_data() == std::vector<FragileCopy>{FragileCopy(1), FragileCopy(2)});
+}
+
+// ========================= COPY-ON-WRITE SNAPSHOTS =========================
+
+// Test that a snapshot shares storage until one side writes
+TEST_CASE("snapshot() shares storage until the next write") {
+    MyContainer<int> c;
+    for (int i = 0; i < 5; ++i) c.add(i);
+
+    MyContainer<int> snap = c.snapshot();
+    CHECK(snap.get_data().data() == c.get_data().data());  // O(1): same buffer
+
+    c.add(5);
+    CHECK(snap.get_data().data() != c.get_data().data());
+    CHECK(snap.size() == 5);
+    CHECK(c.size() == 6);
+
+    MyContainer<int> other = c.snapshot();
+    c[0] = 100;   // Non-const access detaches too
+    c.remove(1);
+    CHECK(other.get_data() == std::vector<int>{0, 1, 2, 3, 4, 5});
+    CHECK(c.get_data() == std::vector<int>{100, 2, 3, 4, 5});
+
+    MyContainer<int> moved = std::move(c);  // Moving leaves a valid container behind
+    CHECK(moved.size() == 5);
+    c.add(7);
+    CHECK(moved.size() == 5);
+}
+
+// Test that Order and ReverseOrder pin the storage they were built from
+TEST_CASE("Order and ReverseOrder iterate a pinned snapshot") {
+    MyContainer<std::string> c;
+    c.add("a");
+    c.add("b");
+
+    auto order = c.order();
+    auto reverse = c.reverse_order();
+    c.add("c");
+    c[0] = "z";
+
+    std::vector<std::string> seen;
+    for (const auto& x : order) seen.push_back(x);
+    CHECK(seen == std::vector<std::string>{"a", "b"});
+    seen.clear();
+    for (const auto& x : reverse) seen.push_back(x);
+    CHECK(seen == std::vector<std::string>{"b", "a"});
+}
+
+// Test readers iterating snapshots on other threads while the owner keeps writing
+TEST_CASE("Snapshots are read concurrently with writes") {
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) c.add(i);
+
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches{0};
+    for (int r = 0; r < 4; ++r) {
+        MyContainer<int> snap = c.snapshot();  // Taken on the writing thread
+        std::vector<int> expected = c.get_data();
+        readers.emplace_back([snap, expected, &mismatches] {
+            for (int round = 0; round < 20; ++round) {
+                size_t i = 0;
+                for (int x : snap.order()) {
+                    if (i >= expected.size() || x != expected[i]) ++mismatches;
+                    ++i;
+                }
+                if (i != expected.size()) ++mismatches;
+                if (*snap.ascending_order().begin() != *std::min_element(expected.begin(), expected.end())) {
+                    ++mismatches;
+                }
+            }
+        });
+        for (int i = 0; i < 1000; ++i) c.add(-i);  // Writes run while readers iterate
+        c.remove(-1);
+    }
+    for (auto& t : readers) t.join();
+
+    CHECK(mismatches == 0);
+    CHECK(c.size() == 4000 + 1000 - 4);
+}
+
+// Test several readers pinning one shared snapshot while the owner writes and detaches
+TEST_CASE("Order and ReverseOrder pin a shared snapshot from several threads") {
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) c.add(i);
+    const MyContainer<int> snap = c.snapshot();  // Taken on the writing thread; only read afterwards
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&snap, &mismatches] {
+            for (int round = 0; round < 50; ++round) {
+                int expected = 0;
+                for (int x : snap.order()) mismatches += x != expected++;
+                expected = 999;
+                for (int x : snap.reverse_order()) mismatches += x != expected--;
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) c.add(-i);
+    c.remove(-1);
+    for (auto& t : readers) t.join();
+
+    CHECK(mismatches == 0);
+    CHECK(snap.size() == 1000);
+}
+
+// ========================= READ-MOSTLY CONTAINER =========================
+
+// Test writes, lock-free reads and orders over a snapshot
+TEST_CASE("ReadMostlyContainer basic operations") {
+    ReadMostlyContainer<int> c;
+    for (int x : {5, 3, 8, 3}) c.add(x);
+    CHECK(c.size() == 4);
+    CHECK(c.contains(8));
+    CHECK(c.at(1) == 3);
+    CHECK_THROWS_AS(c.at(4), std::out_of_range);
+
+    c.remove(3);
+    CHECK(c.size() == 2);
+    CHECK_THROWS_AS(c.remove(42), std::runtime_error);
+    CHECK(c.size() == 2);  // A failed write publishes nothing
+
+    c.update([](MyContainer<int>& m) {
+        m.add(1);
+        m.add(9);
+    });
+    std::vector<int> asc;
+    MyContainer<int> snap = c.snapshot();
+    for (auto x : snap.ascending_order()) asc.push_back(x);
+    CHECK(asc == std::vector<int>{1, 5, 8, 9});
+    CHECK(c.read([](const std::vector<int>& v) { return v.front(); }) == 5);
+
+    MyContainer<int> mine = c.private_copy();  // Same elements, storage of its own
+    CHECK(mine.get_data() == snap.get_data());
+    CHECK(mine.get_data().data() != snap.get_data().data());
+}
+
+// Test that a retired version outlives the readers that can still see it
+TEST_CASE("ReadMostlyContainer reclaims versions after readers leave") {
+    ReadMostlyContainer<std::string> c;
+    c.add("a");
+    c.collect();
+    CHECK(c.retired_versions() == 0);
+
+    {
+        epoch::Guard reading;  // A reader that entered before the next writes
+        c.add("b");
+        c.add("c");
+        CHECK(c.retired_versions() >= 2);
+        CHECK(c.size() == 3);  // Nested guards on the reading thread still work
+    }
+    c.collect();
+    CHECK(c.retired_versions() == 0);
+}
+
+// Test readers running alongside a writer always see a complete version
+TEST_CASE("ReadMostlyContainer concurrent readers and writer") {
+    ReadMostlyContainer<int> c;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done) {
+                // Every published version holds 0..n-1 in order
+                bool ok = c.read([](const std::vector<int>& v) {
+                    for (size_t i = 0; i < v.size(); ++i) {
+                        if (v[i] != static_cast<int>(i)) return false;
+                    }
+                    return true;
+                });
+                if (!ok) ++torn;
+            }
+        });
+    }
+    for (int i = 0; i < 500; ++i) c.add(i);
+    done = true;
+    for (auto& t : readers) t.join();
+
+    CHECK(torn == 0);
+    CHECK(c.size() == 500);
+    c.collect();
+    CHECK(c.retired_versions() == 0);
+}
+
+// ========================= SHARDED CONTAINER =========================
+
+template<typename Order>
+std::vector<typename std::decay<decltype(*std::declval<Order>())>::type> collect_order(const Order& order) {
+    std::vector<typename std::decay<decltype(*std::declval<Order>())>::type> out;
+    for (const auto& x : order) out.push_back(x);
+    return out;
+}
+
+// Test the merged orders against a MyContainer holding the same elements
+TEST_CASE("ShardedContainer orders match MyContainer") {
+    ShardedContainer<int> c(4);
+    MyContainer<int> reference;
+    CHECK(collect_order(c.ascending_order()).empty());
+    CHECK_THROWS_AS(ShardedContainer<int>(0), std::invalid_argument);
+
+    std::vector<std::thread> threads;
+    std::mutex reference_mutex;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 25; ++i) {
+                const int value = (t * 37 + i * 11) % 50;  // Duplicates across shards
+                c.add(value);
+                std::lock_guard<std::mutex> lock(reference_mutex);
+                reference.add(value);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    CHECK(c.size() == 100);
+    CHECK(collect_order(c.ascending_order()) == collect_order(reference.ascending_order()));
+    CHECK(collect_order(c.descending_order()) == collect_order(reference.descending_order()));
+    CHECK(collect_order(c.sidecross_order()) == collect_order(reference.sidecross_order()));
+
+    MyContainer<int> snap = c.snapshot();
+    CHECK(collect_order(snap.ascending_order()) == collect_order(reference.ascending_order()));
+}
+
+// Test remove across shards, including a miss that leaves every shard untouched
+TEST_CASE("ShardedContainer remove") {
+    ShardedContainer<std::string> c(3);
+    std::thread other([&c] { c.add("b"); c.add("a"); });
+    other.join();
+    c.add("a");
+    c.add("c");
+
+    c.remove("a");
+    CHECK_FALSE(c.contains("a"));
+    CHECK(c.size() == 2);
+    CHECK_THROWS_AS(c.remove("z"), std::runtime_error);
+    CHECK(collect_order(c.sidecross_order()) == std::vector<std::string>{"b", "c"});
+}
+
+// Test the parallel shard sort on an input past parallel_threshold
+TEST_CASE("ShardedContainer sorts large shards in parallel") {
+    ShardedContainer<double> c(4);
+    const int per_thread = static_cast<int>(ShardedContainer<double>::parallel_threshold) / 2;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&c, t, per_thread] {
+            for (int i = 0; i < per_thread; ++i) c.add(((i * 7919 + t * 104729) % 100003) - 50000.5);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    std::vector<double> asc = collect_order(c.ascending_order());
+    CHECK(asc.size() == static_cast<size_t>(4 * per_thread));
+    CHECK(std::is_sorted(asc.begin(), asc.end()));
+    std::vector<double> desc = collect_order(c.descending_order());
+    CHECK(std::equal(asc.rbegin(), asc.rend(), desc.begin()));
+}
+
+// ========================= STAGING BUFFERS =========================
+
+// Test splice() moves a batch in order and leaves the batch empty
+TEST_CASE("splice appends a batch in order") {
+    MyContainer<std::string> c;
+    c.add("a");
+    MyContainer<std::string> snap = c.snapshot();
+    std::vector<std::string> batch = {"b", "c"};
+    c.splice(batch);
+    CHECK(batch.empty());
+    CHECK(c.get_data() == std::vector<std::string>{"a", "b", "c"});
+    CHECK(snap.size() == 1);  // Shared storage is copied before the splice
+
+    ContainerStats s = c.stats();
+    CHECK(s.flushes == 1);
+    CHECK(s.flushed_elements == 2);
+    CHECK(s.adds == 1);
+}
+
+// Test per-thread buffers: every value lands once and each thread's values keep their order
+TEST_CASE("StagingBuffers keeps per-thread order") {
+    MyContainer<int> c;
+    const int threads = 4;
+    const int per_thread = 1000;
+    {
+        StagingBuffers<int> staging(c, 64);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&staging, t] {
+                for (int i = 0; i < per_thread; ++i) staging.add(t * per_thread + i);
+            });
+        }
+        for (auto& w : workers) w.join();
+        CHECK(staging.staged() == static_cast<size_t>(threads * (per_thread % 64)));
+
+        staging.flush();
+        CHECK(staging.staged() == 0);
+        CHECK(c.stats().flushes == static_cast<uint64_t>(threads * (per_thread / 64 + 1)));
+        CHECK(c.stats().flushed_elements == static_cast<uint64_t>(threads * per_thread));
+        staging.add(-1);  // Left for the destructor to flush
+    }
+
+    CHECK(c.size() == static_cast<size_t>(threads * per_thread + 1));
+    std::vector<int> last(threads, -1);
+    for (int x : c.order()) {
+        if (x < 0) continue;
+        CHECK(x > last[x / per_thread]);
+        last[x / per_thread] = x;
+    }
+    CHECK(c.get_data().back() == -1);
+}
+
+// Test one thread switching between instances and outliving many of them
+TEST_CASE("StagingBuffers across many instances on one thread") {
+    MyContainer<int> a, b;
+    {
+        StagingBuffers<int> first(a, 4), second(b, 4);
+        for (int i = 0; i < 10; ++i) {
+            first.add(i);   // Each switch finds the thread's existing buffer again
+            second.add(-i);
+        }
+        CHECK(first.staged() == 2);
+        CHECK(second.staged() == 2);
+    }
+    CHECK(a.get_data() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    CHECK(b.size() == 10);
+
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) {
+        StagingBuffers<int> staging(c, 8);
+        staging.add(i);
+    }
+    CHECK(c.size() == 1000);
+    CHECK(c.get_data().back() == 999);
+}
+
+// Element whose copy can be made to fail after it was staged
+struct Refusable {
+    int v;
+    static inline bool refuse = false;
+    explicit Refusable(int value) : v(value) {}
+    Refusable(const Refusable& other) : v(other.v) {
+        if (refuse) throw std::runtime_error("copy refused");
+    }
+    Refusable& operator=(const Refusable&) = default;
+    bool operator==(const Refusable& other) const { return v == other.v; }
+    bool operator<(const Refusable& other) const { return v < other.v; }
+};
+
+// Test that flush() reports a failed splice and the destructor swallows it
+TEST_CASE("StagingBuffers destructor drops what it cannot flush") {
+    MyContainer<Refusable> c;
+    {
+        StagingBuffers<Refusable> staging(c, 8);
+        staging.add(Refusable(1));
+        Refusable::refuse = true;
+        CHECK_THROWS_AS(staging.flush(), std::runtime_error);
+        CHECK(staging.staged() == 1);
+    }  // Fails again here, without terminating
+    Refusable::refuse = false;
+    CHECK(c.size() == 0);
+}
+
+// ========================= PARALLEL ORDER CONSTRUCTION =========================
+
+// Test parallel_for runs every index once, including from inside a worker, and rethrows
+TEST_CASE("ThreadPool parallel_for") {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> hits(10000);
+    pool.parallel_for(hits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ++hits[i];
+    });
+    CHECK(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }));
+
+    std::atomic<size_t> nested{0};
+    pool.parallel_for(8, 1, [&](size_t, size_t) {
+        pool.parallel_for(100, 10, [&](size_t begin, size_t end) { nested += end - begin; });
+    });
+    CHECK(nested == 800);
+
+    CHECK_THROWS_AS(pool.parallel_for(100, 1, [](size_t begin, size_t) {
+        if (begin == 42) throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+}
+
+// Element type without a default constructor: orders stay on the calling thread
+struct Boxed {
+    int v;
+    explicit Boxed(int x) : v(x) {}
+    bool operator==(const Boxed& other) const { return v == other.v; }
+    bool operator<(const Boxed& other) const { return v < other.v; }
+};
+
+// Large orders built in chunks match the element-by-element definitions
+TEST_CASE_TEMPLATE("Orders above the parallel threshold", T, int, std::string) {
+    const size_t n = detail::parallel_min_elements + 7;  // Odd, with a partial last chunk
+    std::vector<T> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const int x = static_cast<int>((i * 7919) % 100003);
+        if constexpr (std::is_same<T, int>::value) values.push_back(x);
+        else values.push_back(std::to_string(x));
+    }
+    MyContainer<T> c(values);
+
+    std::vector<T> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(collect_order(c.ascending_order()) == sorted);
+    CHECK(collect_order(c.descending_order()) == std::vector<T>(sorted.rbegin(), sorted.rend()));
+
+    std::vector<T> side;
+    for (size_t left = 0, right = n; left < right;) {
+        side.push_back(sorted[left++]);
+        if (left < right) side.push_back(sorted[--right]);
+    }
+    CHECK(collect_order(c.sidecross_order()) == side);
+
+    std::vector<T> middle = {values[n / 2]};
+    for (size_t step = 1; middle.size() < n; ++step) {
+        middle.push_back(values[n / 2 - step]);
+        if (n / 2 + step < n) middle.push_back(values[n / 2 + step]);
+    }
+    CHECK(collect_order(c.middle_out_order()) == middle);
+}
+
+TEST_CASE("Orders above the parallel threshold without a default constructor") {
+    MyContainer<Boxed> c;
+    const int n = static_cast<int>(detail::parallel_min_elements) + 2;
+    for (int i = n - 1; i >= 0; --i) c.add(Boxed(i));
+
+    std::vector<Boxed> side = collect_order(c.sidecross_order());
+    CHECK(side.front().v == 0);
+    CHECK(side[1].v == n - 1);
+    CHECK(side.back().v == n / 2);
+    CHECK(collect_order(c.descending_order()).front().v == n - 1);
+    CHECK(collect_order(c.middle_out_order()).front().v == n - 1 - n / 2);
+}
+
+// ========================= PARALLEL ALGORITHMS =========================
+
+// Test every order exposes its sequence by position
+TEST_CASE("Orders are indexable by position") {
+    MyContainer<int> c;
+    for (int x : {7, 15, 6, 1, 2}) c.add(x);
+
+    c.add(7);  // A duplicate, so the grouped orders differ from the others
+
+    auto check = [](const auto& order) {
+        const auto walked = collect_order(order);
+        REQUIRE(order.size() == walked.size());
+        for (size_t i = 0; i < walked.size(); ++i) CHECK(order[i] == walked[i]);
+    };
+    check(c.ascending_order());
+    check(c.descending_order());
+    check(c.sidecross_order());
+    check(c.reverse_order());
+    check(c.order());
+    check(c.middle_out_order());
+    check(c.grouped_ascending_order());
+    check(c.distinct_order());
+    check(c.frequency_order());
+    CHECK(c.distinct_order().size() == 5);
+    CHECK(c.frequency_order()[0] == std::make_pair(7, size_t(2)));
+}
+
+// Test parallel_for_each visits every element of an order exactly once
+TEST_CASE("parallel_for_each over an order") {
+    MyContainer<int> c;
+    const int n = 20000;
+    for (int i = n - 1; i >= 0; --i) c.add(i);
+
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> seen(n);
+    auto asc = c.ascending_order();
+    parallel_for_each(asc, [&seen](int x) { ++seen[x]; }, 0, pool);
+    CHECK(std::all_of(seen.begin(), seen.end(), [](const std::atomic<int>& s) { return s == 1; }));
+
+    auto middle = c.middle_out_order();
+    CHECK_THROWS_AS(parallel_for_each(middle, [](int x) {
+        if (x == 123) throw std::runtime_error("bad element");
+    }, 16, pool), std::runtime_error);
+}
+
+// Test an associative but non-commutative reduction keeps the order's sequence
+TEST_CASE("parallel_transform_reduce keeps order for ordered reductions") {
+    MyContainer<int> c;
+    for (int i = 0; i < 3000; ++i) c.add((i * 37) % 3000);
+
+    ThreadPool pool(3);
+    auto concat = [](std::string a, const std::string& b) { return a + b; };
+    auto digit = [](int x) { return std::to_string(x % 10); };
+
+    auto side = c.sidecross_order();
+    std::string expected = ">";
+    for (int x : side) expected += digit(x);
+    CHECK(parallel_transform_reduce(side, std::string(">"), concat, digit, 7, pool) == expected);
+
+    auto rev = c.reverse_order();
+    long sum = parallel_transform_reduce(rev, 0L, std::plus<long>(), [](int x) { return long(x); }, 0, pool);
+    CHECK(sum == 2999L * 3000 / 2);
+
+    MyContainer<int> empty;
+    CHECK(parallel_transform_reduce(empty.order(), 5, std::plus<int>(), [](int x) { return x; }) == 5);
+}
+
+// ========================= ORDER SLICES =========================
+
+// Test split(k) covers the order exactly once, in position order, with near-equal slices
+TEST_CASE("split and chunk cover every order") {
+    MyContainer<int> c;
+    for (int x : {9, 4, 7, 1, 8, 2, 6, 3, 5, 10, 0}) c.add(x);
+
+    auto check = [](const auto& order) {
+        const auto whole = collect_order(order);
+        for (size_t k : {1, 2, 3, 4, 11, 15}) {
+            std::remove_const_t<decltype(whole)> joined;
+            size_t expected_offset = 0;
+            for (const auto& slice : order.split(k)) {
+                CHECK(slice.offset() == expected_offset);
+                CHECK(slice.size() >= whole.size() / k);
+                CHECK(slice.size() <= whole.size() / k + 1);
+                for (size_t i = 0; i < slice.size(); ++i) CHECK(slice[i] == whole[slice.offset() + i]);
+                for (const auto& x : slice) joined.push_back(x);
+                expected_offset += slice.size();
+            }
+            CHECK(joined == whole);
+        }
+        CHECK(collect_order(order.chunk(1, 3)) == std::remove_const_t<decltype(whole)>(whole.begin() + 4, whole.begin() + 8));
+        CHECK_THROWS_AS(order.chunk(3, 3), std::out_of_range);
+        CHECK_THROWS_AS(order.split(0), std::invalid_argument);
+    };
+    check(c.ascending_order());
+    check(c.descending_order());
+    check(c.sidecross_order());
+    check(c.reverse_order());
+    check(c.order());
+    check(c.middle_out_order());
+    check(c.grouped_ascending_order());
+    check(c.distinct_order());
+    check(c.frequency_order());
+
+    auto asc = c.ascending_order();
+    auto empty_slice = asc.chunk(14, 15);  // More chunks than elements leaves some empty
+    CHECK(empty_slice.size() == 0);
+    CHECK_THROWS_AS(*empty_slice, std::out_of_range);
+}
+
+// Test slices processed on separate threads without copying the order
+TEST_CASE("Slices of an order on separate threads") {
+    MyContainer<int> c;
+    const int n = 10000;
+    for (int i = 0; i < n; ++i) c.add((i * 7919) % n);
+
+    auto middle = c.middle_out_order();
+    auto slices = middle.split(4);
+    std::vector<long> sums(slices.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < slices.size(); ++t) {
+        threads.emplace_back([&sums, &slices, t] {
+            for (int x : slices[t]) sums[t] += x;
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK(std::accumulate(sums.begin(), sums.end(), 0L) == long(n - 1) * n / 2);
+
+    // Slices have size() and operator[], so the parallel algorithms accept them too
+    ShardedContainer<int> sharded(2);
+    for (int i = 0; i < 100; ++i) sharded.add(i);
+    auto asc = sharded.ascending_order();
+    auto upper = asc.chunk(1, 2);
+    CHECK(parallel_transform_reduce(upper, 0, std::plus<int>(), [](int x) { return x; }) == (50 + 99) * 50 / 2);
+}
+
+// ========================= SIDECROSS QUEUE =========================
+
+// Test draining a queue built from a container matches sidecross_order()
+TEST_CASE_TEMPLATE("SideCrossQueue drains like sidecross_order", T, int, std::string) {
+    for (int n : {0, 1, 2, 3, 10, 257}) {
+        MyContainer<T> c;
+        for (int i = 0; i < n; ++i) {
+            const int x = (i * 7919) % 97;  // Duplicates once n passes 97
+            if constexpr (std::is_same<T, int>::value) c.add(x);
+            else c.add(std::to_string(x));
+        }
+        SideCrossQueue<T> q(c);
+        CHECK(q.size() == static_cast<size_t>(n));
+
+        std::vector<T> drained;
+        while (!q.empty()) drained.push_back(q.pop_sidecross());
+        CHECK(drained == collect_order(c.sidecross_order()));
+    }
+}
+
+// Test interleaved pushes and pops against a sorted multiset
+TEST_CASE("SideCrossQueue with interleaved pushes and pops") {
+    SideCrossQueue<int> q;
+    std::multiset<int> reference;
+    CHECK_THROWS_AS(q.min(), std::out_of_range);
+    CHECK_THROWS_AS(q.pop_max(), std::out_of_range);
+    CHECK_THROWS_AS(q.pop_sidecross(), std::out_of_range);
+
+    unsigned state = 12345;
+    auto next = [&state] { state = state * 1103515245u + 12345u; return (state >> 16) & 0x7fff; };
+    for (int step = 0; step < 5000; ++step) {
+        const unsigned action = next() % 4;
+        if (action < 2 || reference.empty()) {
+            const int x = static_cast<int>(next() % 500);
+            q.push(x);
+            reference.insert(x);
+        } else if (action == 2) {
+            CHECK(q.pop_min() == *reference.begin());
+            reference.erase(reference.begin());
+        } else {
+            CHECK(q.pop_max() == *reference.rbegin());
+            reference.erase(std::prev(reference.end()));
+        }
+        REQUIRE(q.size() == reference.size());
+        if (!reference.empty()) {
+            CHECK(q.min() == *reference.begin());
+            CHECK(q.max() == *reference.rbegin());
+        }
+    }
+
+    // pop_sidecross keeps alternating across arrivals
+    SideCrossQueue<int> s;
+    for (int x : {5, 1, 9}) s.push(x);
+    CHECK(s.pop_sidecross() == 1);
+    s.push(0);
+    s.push(20);
+    CHECK(s.pop_sidecross() == 20);
+    CHECK(s.pop_sidecross() == 0);
+    CHECK(s.pop_sidecross() == 9);
+    CHECK(s.pop_sidecross() == 5);
+}
+
+// ========================= BACKGROUND PRECOMPUTATION =========================
+
+// Test a burst of writes is sorted once, in the background, after it goes quiet
+TEST_CASE("PrecomputedContainer sorts once per write burst") {
+    PrecomputedContainer<int> c(std::chrono::milliseconds(50));
+    CHECK(c.view_ready());
+    CHECK(c.ascending()->empty());
+
+    std::vector<int> expected;
+    for (int i = 0; i < 200; ++i) {
+        const int x = (i * 7919) % 211;
+        c.add(x);
+        expected.push_back(x);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    // A slow machine may pause mid-burst long enough to publish an early view;
+    // whatever was published so far, the full contents are published at most once
+    const uint64_t before = c.rebuilds();
+    auto future = c.sorted_view();
+    PrecomputedContainer<int>::View view = future.get();  // Waits out the quiet period and the sort
+    CHECK(*view == expected);
+    CHECK(c.view_ready());
+    CHECK(c.rebuilds() >= 1);
+    CHECK(c.rebuilds() <= before + 1);
+    CHECK(c.ascending() == view);  // Ready views are shared, not rebuilt
+
+    // A miss changes nothing and keeps the view
+    CHECK_THROWS_AS(c.remove(-1), std::runtime_error);
+    CHECK(c.view_ready());
+
+    // Later writes leave earlier views untouched
+    c.remove(expected.front());
+    c.add(1000);
+    PrecomputedContainer<int>::View next = c.ascending();
+    CHECK(next->back() == 1000);
+    CHECK(std::count(next->begin(), next->end(), expected.front()) == 0);
+    CHECK(*view == expected);
+    CHECK(c.size() == next->size());
+}
+
+// Test readers on other threads all receive the view of the final contents
+TEST_CASE("PrecomputedContainer readers wait on the pending sort") {
+    PrecomputedContainer<std::string> c(std::chrono::milliseconds(1));
+    for (int i = 0; i < 50; ++i) c.add(std::to_string(i));
+
+    std::vector<std::thread> readers;
+    std::atomic<int> complete{0};
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&c, &complete] {
+            auto view = c.ascending();
+            if (view->size() == 50 && std::is_sorted(view->begin(), view->end())) ++complete;
+        });
+    }
+    for (auto& t : readers) t.join();
+    CHECK(complete == 4);
+
+    MyContainer<std::string> snap = c.snapshot();
+    CHECK(collect_order(snap.ascending_order()) == *c.ascending());
+}
+
+// Test destruction while a sort is still waiting for writes to go quiet
+TEST_CASE("PrecomputedContainer stops with a pending sort") {
+    std::shared_future<PrecomputedContainer<int>::View> future;
+    {
+        PrecomputedContainer<int> c(std::chrono::seconds(10));
+        c.add(1);
+        future = c.sorted_view();
+    }
+    CHECK_THROWS_AS(future.get(), std::future_error);  // Broken promise
+}
@@ -0,0 +1,37 @@
+// Compile-time checks that the opt-in instrumentation costs nothing when off.
+//
+// Built by `make test` with statistics, latency histograms and tracing all
+// disabled, as users get the header by default. Every check is a
+// static_assert, so a recorder that gains a member, or a hook that stops
+// compiling to nothing, fails the build rather than a test run.
+
+#define MYCONTAINER_ENABLE_STATS 0
+#define MYCONTAINER_ENABLE_LATENCY 0
+#define MYCONTAINER_ENABLE_TRACE 0
+#include "../include/MyContainer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace myns;
+
+static_assert(!MyContainer<int>::stats_enabled && !MyContainer<int>::latency_enabled && !trace::enabled,
+              "zero_overhead.cpp must be built with every recorder off");
+
+// The recorders are empty bases, and their scopes empty objects
+static_assert(std::is_empty_v<detail::stats_recorder>, "stats_recorder must be empty when compiled out");
+static_assert(std::is_empty_v<detail::latency_recorder>, "latency_recorder must be empty when compiled out");
+static_assert(std::is_empty_v<detail::stats_recorder::sort_timer>, "sort_timer must be empty when compiled out");
+static_assert(std::is_empty_v<detail::stats_recorder::flush_timer>, "flush_timer must be empty when compiled out");
+static_assert(std::is_empty_v<detail::latency_recorder::latency_scope>, "latency_scope must be empty when compiled out");
+static_assert(std::is_empty_v<trace::Scope>, "trace::Scope must be empty when compiled out");
+
+// Storage pointer, growth factor, scratch counter pointer and shared flag,
+// and nothing from the recorders. Update the figure only when a member is
+// added on purpose.
+#if UINTPTR_MAX == UINT64_MAX
+static_assert(sizeof(std::shared_ptr<std::vector<int>>) == 16, "unexpected shared_ptr layout");
+static_assert(sizeof(MyContainer<int>) == 40, "MyContainer<int> grew with instrumentation off");
+#endif